@@ -17,6 +17,37 @@ CCliControlService::CCliControlService()
 {
 }
 
+void CCliControlService::setSamplerParams(const odc::core::SSamplerParams& _params)
+{
+    m_samplerParams = _params;
+    m_service->setSamplerParams(_params);
+}
+
+void CCliControlService::setEventLogDir(const std::string& _dir)
+{
+    m_service->setEventLogDir(_dir);
+}
+
+void CCliControlService::setConfigDir(const std::string& _dir)
+{
+    m_service->setConfigDir(_dir);
+}
+
+void CCliControlService::setAgentCheckInterval(const std::chrono::milliseconds& _interval)
+{
+    m_service->setAgentCheckInterval(_interval);
+}
+
+void CCliControlService::setShmMonitorInterval(const std::chrono::milliseconds& _interval)
+{
+    m_service->setShmMonitorInterval(_interval);
+}
+
+void CCliControlService::setExchangeTiming(bool _enabled)
+{
+    m_service->setExchangeTiming(_enabled);
+}
+
 std::string CCliControlService::requestInitialize(const odc::core::SInitializeParams& _params)
 {
     return generalReply(m_service->execInitialize(_params));
@@ -42,6 +73,11 @@ std::string CCliControlService::requestDownscale(const odc::core::SUpdateParams&
     return generalReply(m_service->execUpdate(_params));
 }
 
+std::string CCliControlService::requestRollingUpdate(const odc::core::SUpdateParams& _params)
+{
+    return generalReply(m_service->execUpdate(_params));
+}
+
 std::string CCliControlService::requestConfigure(const odc::core::SDeviceParams& _params)
 {
     return generalReply(m_service->execConfigure(_params));
@@ -72,6 +108,71 @@ std::string CCliControlService::requestShutdown()
     return generalReply(m_service->execShutdown());
 }
 
+std::string CCliControlService::requestSetProperty(const odc::core::SSetPropertyParams& _params)
+{
+    return generalReply(m_service->execSetProperty(_params));
+}
+
+std::string CCliControlService::requestSaveConfig(const odc::core::SSaveConfigParams& _params)
+{
+    return generalReply(m_service->execSaveConfig(_params));
+}
+
+std::string CCliControlService::requestApplyConfig(const odc::core::SApplyConfigParams& _params)
+{
+    return generalReply(m_service->execApplyConfig(_params));
+}
+
+std::string CCliControlService::requestGetProperties(const odc::core::SGetPropertiesParams& _params)
+{
+    return generalReply(m_service->execGetProperties(_params));
+}
+
+std::string CCliControlService::requestGetTopology(const odc::core::SGetTopologyParams& _params)
+{
+    return generalReply(m_service->execGetTopology(_params));
+}
+
+std::string CCliControlService::requestMetrics()
+{
+    return generalReply(m_service->execGetMetrics());
+}
+
+std::string CCliControlService::requestDiagnostics()
+{
+    return generalReply(m_service->execDiagnostics());
+}
+
+std::string CCliControlService::requestThroughput(size_t _numSamples)
+{
+    stringstream ss;
+    uint64_t sequence{ 0 };
+    // Allow for the maximum jitter of the sampling interval
+    const chrono::milliseconds timeout{ 2 * m_samplerParams.m_interval + chrono::seconds(1) };
+    for (size_t i = 0; i < _numSamples; ++i)
+    {
+        SThroughputSample sample;
+        if (!m_service->waitForThroughputSample(sequence, timeout, sample))
+        {
+            ss << "  Timed out waiting for throughput sample" << endl;
+            break;
+        }
+        sequence = sample.m_sequence;
+        throughputReply(ss, sample);
+    }
+    return ss.str();
+}
+
+void CCliControlService::throughputReply(std::stringstream& _ss, const SThroughputSample& _sample)
+{
+    _ss << "  Throughput sample " << _sample.m_sequence << " at " << _sample.m_timestamp << " ms: " << endl;
+    for (const auto& value : _sample.m_values)
+    {
+        _ss << "    { " << value.m_scope << ": " << value.m_name << "; key: " << value.m_key
+            << "; value: " << value.m_value << "; devices: " << value.m_numDevices << " }" << endl;
+    }
+}
+
 string CCliControlService::generalReply(const SReturnValue& _value)
 {
     stringstream ss;
@@ -88,17 +189,255 @@ string CCliControlService::generalReply(const SReturnValue& _value)
 
     ss << "  Run ID: " << _value.m_runID << endl;
     ss << "  Session ID: " << _value.m_sessionID << endl;
+    ss << "  Topology version: " << _value.m_topologyVersion << " (hash: " << _value.m_topologyHash << ")" << endl;
 
     if (_value.m_details != nullptr)
     {
-        ss << endl << "  Devices: " << endl;
+        const SAgentPlan& plan{ _value.m_details->m_agentPlan };
+        if (plan.m_numAgents > 0)
+        {
+            ss << "  Agents: " << plan.m_numAgents << " with " << plan.m_numSlots << " slots for " << plan.m_numTasks
+               << " tasks in " << plan.m_numCollections << " collections" << endl;
+        }
+
         const auto& topologyState = _value.m_details->m_topologyState;
-        for (const auto& state : topologyState)
+        if (!topologyState.empty())
+        {
+            ss << endl << "  Devices: " << endl;
+            for (const auto& state : topologyState)
+            {
+                ss << "    { id: " << state.m_status.taskId << "; path: " << state.m_path
+                   << "; state: " << fair::mq::GetStateName(state.m_status.state) << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const STopologyStructure& topology{ _value.m_details->m_topology };
+        if (topology.m_topologyVersion > 0)
+        {
+            ss << endl << "  Topology version " << topology.m_topologyVersion << ": " << endl;
+            for (const auto& group : topology.m_groups)
+            {
+                ss << "    { group: " << group.m_name << "; n: " << group.m_n << " }" << endl;
+            }
+            for (const auto& collection : topology.m_collections)
+            {
+                ss << "    { collection: " << collection.m_id << "; path: " << topology.m_paths[collection.m_path]
+                   << "; tasks: " << collection.m_numTasks << " }" << endl;
+            }
+            for (const auto& task : topology.m_tasks)
+            {
+                ss << "    { task: " << task.m_id << "; path: " << topology.m_paths[task.m_path]
+                   << "; collection: " << task.m_collectionID << "; host: " << topology.m_hosts[task.m_host]
+                   << "; channels:";
+                for (const auto& property : task.m_properties)
+                {
+                    ss << " " << topology.m_properties[property.m_name] << "(" << (property.m_read ? "r" : "")
+                       << (property.m_write ? "w" : "") << ")";
+                }
+                ss << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& deviceProperties = _value.m_details->m_deviceProperties;
+        if (!deviceProperties.empty())
+        {
+            ss << endl << "  Properties: " << endl;
+            for (const auto& device : deviceProperties)
+            {
+                ss << "    { id: " << device.m_deviceID << "; path: " << device.m_path << "; properties:";
+                for (const auto& property : device.m_properties)
+                {
+                    ss << " " << property.first << "=" << property.second;
+                }
+                ss << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& aggregates = _value.m_details->m_propertyAggregates;
+        if (!aggregates.empty())
+        {
+            ss << endl << "  Aggregated properties: " << endl;
+            for (const auto& aggregate : aggregates)
+            {
+                ss << "    { key: " << aggregate.m_key << "; devices: " << aggregate.m_numDevices
+                   << "; distinct: " << aggregate.m_numDistinct;
+                if (aggregate.m_numeric)
+                {
+                    ss << "; min: " << aggregate.m_min << "; max: " << aggregate.m_max;
+                }
+                ss << "; values:";
+                for (const auto& value : aggregate.m_values)
+                {
+                    ss << " " << value.first << "(" << value.second << ")";
+                }
+                ss << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& failedDevices = _value.m_details->m_failedDevices;
+        if (!failedDevices.empty())
+        {
+            ss << "  Failed devices:";
+            for (const auto& id : failedDevices)
+            {
+                ss << " " << id;
+            }
+            ss << endl;
+        }
+
+        const auto& excluded = _value.m_details->m_excludedCollections;
+        if (!excluded.empty())
+        {
+            ss << "  Excluded collections:";
+            for (const auto& path : excluded)
+            {
+                ss << " " << path;
+            }
+            ss << endl;
+        }
+
+        const auto& skew = _value.m_details->m_startSkew;
+        if (skew.m_targetTime > 0)
+        {
+            ss << "  Start skew: { devices: " << skew.m_numDevices << "; scheduled: " << skew.m_targetTime
+               << "; median: " << skew.m_median << " msec; p90: " << skew.m_p90 << " msec; p99: " << skew.m_p99
+               << " msec; max: " << skew.m_max << " msec; late: " << skew.m_numLate << " }" << endl;
+        }
+
+        const auto& memoryStats = _value.m_details->m_memoryStats;
+        if (!memoryStats.empty())
+        {
+            ss << endl << "  Memory: " << endl;
+            for (const auto& stat : memoryStats)
+            {
+                ss << "    { subsystem: " << stat.m_subsystem << "; current: " << stat.m_current
+                   << " bytes; peak: " << stat.m_peak << " bytes }" << endl;
+            }
+            ss << endl;
+        }
+
+        if (_value.m_details->m_throughput.m_sequence > 0)
+        {
+            throughputReply(ss, _value.m_details->m_throughput);
+            ss << endl;
+        }
+
+        const auto& waves = _value.m_details->m_waves;
+        if (!waves.empty())
+        {
+            ss << endl << "  Waves: " << endl;
+            for (const auto& wave : waves)
+            {
+                ss << "    { wave: " << wave.m_index << "; added: " << wave.m_numAdded
+                   << "; removed: " << wave.m_numRemoved << "; capacity: " << wave.m_capacity
+                   << "; activate: " << wave.m_activateTime << " msec; start: " << wave.m_startTime
+                   << " msec; retire: " << wave.m_retireTime << " msec; " << ((wave.m_success) ? "done" : "failed")
+                   << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& launchLatencies = _value.m_details->m_launchLatencies;
+        if (!launchLatencies.empty())
+        {
+            ss << endl << "  Launch latency: " << endl;
+            for (const auto& latency : launchLatencies)
+            {
+                ss << "    { " << latency.m_scope << ": " << latency.m_name << "; tasks: " << latency.m_numTasks
+                   << "; start median: " << latency.m_launchMedian << " msec; start max: " << latency.m_launchMax
+                   << " msec; reported: " << latency.m_numReported << "; state median: " << latency.m_stateMedian
+                   << " msec; state max: " << latency.m_stateMax << " msec }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& colocatedChannels = _value.m_details->m_colocatedChannels;
+        if (!colocatedChannels.empty())
+        {
+            ss << endl << "  Shared memory channels: " << endl;
+            for (const auto& channel : colocatedChannels)
+            {
+                ss << "    { channel: " << channel.m_channel
+                   << "; collection: " << (channel.m_collection.empty() ? "-" : channel.m_collection)
+                   << "; host: " << channel.m_host << "; devices: " << channel.m_numDevices << " }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& propertyLatencies = _value.m_details->m_propertyLatencies;
+        if (!propertyLatencies.empty())
+        {
+            ss << endl << "  Property exchange: " << endl;
+            for (const auto& latency : propertyLatencies)
+            {
+                ss << "    { property: " << latency.m_property
+                   << "; host: " << (latency.m_host.empty() ? "all" : latency.m_host)
+                   << "; writers: " << latency.m_numWriters << "; readers: " << latency.m_numReaders
+                   << "; published: " << latency.m_publishTime << " msec; median: " << latency.m_median
+                   << " msec; p90: " << latency.m_p90 << " msec; max: " << latency.m_max << " msec }" << endl;
+            }
+            ss << endl;
+        }
+
+        const SProcessDiagnostics& process{ _value.m_details->m_process };
+        if (process.m_rss > 0 || !process.m_threads.empty())
+        {
+            const SServiceDiagnostics& diagnostics{ _value.m_details->m_diagnostics };
+            ss << endl
+               << "  Process: RSS " << process.m_rss << " bytes; peak RSS " << process.m_peakRSS << " bytes; session "
+               << (diagnostics.m_sessionRunning ? diagnostics.m_sessionID : "none") << endl;
+            for (const auto& thread : process.m_threads)
+            {
+                ss << "    { thread: " << thread.m_tid << "; name: " << thread.m_name << "; user: " << thread.m_userTime
+                   << " msec; system: " << thread.m_systemTime << " msec; voluntary switches: "
+                   << thread.m_voluntarySwitches << "; involuntary switches: " << thread.m_involuntarySwitches << " }"
+                   << endl;
+            }
+            for (const auto& operation : diagnostics.m_operations)
+            {
+                ss << "    { operation: " << operation.m_name << "; age: " << operation.m_age << " msec }" << endl;
+            }
+            for (const auto& lock : diagnostics.m_locks)
+            {
+                ss << "    { lock: " << lock.m_name << "; locks: " << lock.m_numLocks << "; waits: " << lock.m_numWaits
+                   << "; wait total: " << lock.m_waitTotal << " usec; wait max: " << lock.m_waitMax << " usec }"
+                   << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& ddsRequests = _value.m_details->m_ddsRequests;
+        if (!ddsRequests.empty())
+        {
+            ss << endl << "  DDS requests: " << endl;
+            for (const auto& stat : ddsRequests)
+            {
+                const SDurationHistogram& done{ stat.m_done };
+                ss << "    { request: " << stat.m_request << "; count: " << stat.m_count
+                   << "; failed: " << stat.m_numFailed << "; messages: " << stat.m_numMessages
+                   << "; first message p50: " << stat.m_firstMessage.quantile(0.5)
+                   << " msec; done p50: " << done.quantile(0.5) << " msec; p90: " << done.quantile(0.9)
+                   << " msec; p99: " << done.quantile(0.99) << " msec; max: " << done.m_max << " msec }" << endl;
+            }
+            ss << endl;
+        }
+
+        const auto& shmStats = _value.m_details->m_shmStats;
+        if (!shmStats.empty())
         {
-            ss << "    { id: " << state.m_status.taskId << "; path: " << state.m_path
-               << "; state: " << fair::mq::GetStateName(state.m_status.state) << " }" << endl;
+            ss << endl << "  Shared memory: " << endl;
+            for (const auto& stat : shmStats)
+            {
+                ss << "    { host: " << stat.m_host << "; segment: " << stat.m_segment << "; used: "
+                   << (stat.m_size - stat.m_free) << " bytes; free: " << stat.m_free
+                   << " bytes; fragmentation: " << stat.fragmentation() << " }" << endl;
+            }
+            ss << endl;
         }
-        ss << endl;
     }
 
     ss << "  Execution time: " << _value.m_execTime << " msec" << endl;
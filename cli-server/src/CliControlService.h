@@ -8,6 +8,8 @@
 // ODC
 #include "CliServiceHelper.h"
 #include "ControlService.h"
+// STD
+#include <sstream>
 
 namespace odc
 {
@@ -18,23 +20,41 @@ namespace odc
           public:
             CCliControlService();
 
+            void setSamplerParams(const odc::core::SSamplerParams& _params);
+            void setEventLogDir(const std::string& _dir);
+            void setConfigDir(const std::string& _dir);
+            void setAgentCheckInterval(const std::chrono::milliseconds& _interval);
+            void setShmMonitorInterval(const std::chrono::milliseconds& _interval);
+            void setExchangeTiming(bool _enabled);
+
             std::string requestInitialize(const odc::core::SInitializeParams& _params);
             std::string requestSubmit(const odc::core::SSubmitParams& _params);
             std::string requestActivate(const odc::core::SActivateParams& _params);
             std::string requestUpscale(const odc::core::SUpdateParams& _params);
             std::string requestDownscale(const odc::core::SUpdateParams& _params);
+            std::string requestRollingUpdate(const odc::core::SUpdateParams& _params);
             std::string requestConfigure(const odc::core::SDeviceParams& _params);
             std::string requestStart(const odc::core::SDeviceParams& _params);
             std::string requestStop(const odc::core::SDeviceParams& _params);
             std::string requestReset(const odc::core::SDeviceParams& _params);
             std::string requestTerminate(const odc::core::SDeviceParams& _params);
             std::string requestShutdown();
+            std::string requestSetProperty(const odc::core::SSetPropertyParams& _params);
+            std::string requestSaveConfig(const odc::core::SSaveConfigParams& _params);
+            std::string requestApplyConfig(const odc::core::SApplyConfigParams& _params);
+            std::string requestGetProperties(const odc::core::SGetPropertiesParams& _params);
+            std::string requestGetTopology(const odc::core::SGetTopologyParams& _params);
+            std::string requestMetrics();
+            std::string requestDiagnostics();
+            std::string requestThroughput(size_t _numSamples);
 
           private:
             std::string generalReply(const odc::core::SReturnValue& _value);
+            void throughputReply(std::stringstream& _ss, const odc::core::SThroughputSample& _sample);
 
           private:
             std::shared_ptr<odc::core::CControlService> m_service; ///< Core ODC service
+            odc::core::SSamplerParams m_samplerParams;             ///< Parameters of the throughput sampler
         };
     } // namespace cli
 } // namespace odc
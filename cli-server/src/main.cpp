@@ -29,12 +29,19 @@ int main(int argc, char** argv)
         size_t timeout;
         SInitializeParams initializeParams;
         SSubmitParams submitParams;
+        SSamplerParams samplerParams;
         SActivateParams activateParams;
         SUpdateParams upscaleParams;
         SUpdateParams downscaleParams;
         CLogger::SConfig logConfig;
+        string configDir;
+        size_t agentCheckInterval;
+        size_t shmMonitorInterval;
+        bool exchangeTiming;
         SDeviceParams recoDeviceParams;
         SDeviceParams qcDeviceParams;
+        SStragglerParams stragglerParams;
+        SRetryParams retryParams;
 
         // Generic options
         bpo::options_description options("odc-cli-server options");
@@ -48,8 +55,15 @@ int main(int argc, char** argv)
         CCliHelper::addUpscaleOptions(options, SUpdateParams(defaultUpscaleTopo), upscaleParams);
         string defaultDownscaleTopo(kODCDataDir + "/ex-dds-topology-infinite-down.xml");
         CCliHelper::addDownscaleOptions(options, SUpdateParams(defaultDownscaleTopo), downscaleParams);
+        CCliHelper::addSamplerOptions(options, SSamplerParams(), samplerParams);
         CCliHelper::addLogOptions(options, CLogger::SConfig(), logConfig);
+        CCliHelper::addConfigDirOptions(options, "", configDir);
+        CCliHelper::addAgentWatchdogOptions(options, 0, agentCheckInterval);
+        CCliHelper::addShmMonitorOptions(options, 5000, shmMonitorInterval);
+        CCliHelper::addExchangeTimingOptions(options, false, exchangeTiming);
         CCliHelper::addDeviceOptions(options, SDeviceParams(), recoDeviceParams, SDeviceParams(), qcDeviceParams);
+        CCliHelper::addStragglerOptions(options, SStragglerParams(), stragglerParams);
+        CCliHelper::addRetryOptions(options, SRetryParams(), retryParams);
 
         // Parsing command-line
         bpo::variables_map vm;
@@ -92,6 +106,12 @@ int main(int argc, char** argv)
 
         odc::cli::CCliControlService control;
         control.setTimeout(chrono::seconds(timeout));
+        control.setSamplerParams(samplerParams);
+        control.setEventLogDir(logConfig.m_logDir);
+        control.setConfigDir(configDir.empty() ? logConfig.m_logDir : configDir);
+        control.setAgentCheckInterval(chrono::seconds(agentCheckInterval));
+        control.setShmMonitorInterval(chrono::milliseconds(shmMonitorInterval));
+        control.setExchangeTiming(exchangeTiming);
         control.setInitializeParams(initializeParams);
         control.setSubmitParams(submitParams);
         control.setActivateParams(activateParams);
@@ -99,6 +119,8 @@ int main(int argc, char** argv)
         control.setDownscaleParams(downscaleParams);
         control.setRecoDeviceParams(recoDeviceParams);
         control.setQCDeviceParams(qcDeviceParams);
+        control.setStragglerParams(stragglerParams);
+        control.setRetryParams(retryParams);
         control.run();
     }
     catch (exception& _e)
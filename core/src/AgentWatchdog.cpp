@@ -0,0 +1,160 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "AgentWatchdog.h"
+#include "Logger.h"
+// STD
+#include <algorithm>
+
+using namespace odc::core;
+using namespace std;
+
+constexpr chrono::milliseconds CAgentWatchdog::kMinBackoff;
+constexpr chrono::milliseconds CAgentWatchdog::kMaxBackoff;
+
+CAgentWatchdog::CAgentWatchdog(count_t _count, replace_t _replace)
+    : m_count(_count)
+    , m_replace(_replace)
+{
+}
+
+CAgentWatchdog::~CAgentWatchdog()
+{
+    stop();
+}
+
+void CAgentWatchdog::start(const chrono::milliseconds& _interval)
+{
+    stop();
+    if (_interval.count() <= 0)
+        return;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = false;
+    }
+    m_thread = thread(&CAgentWatchdog::run, this, _interval);
+    OLOG(ESeverity::info) << "Agent watchdog started with interval " << _interval.count() << " ms";
+}
+
+void CAgentWatchdog::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+    OLOG(ESeverity::info) << "Agent watchdog stopped";
+}
+
+bool CAgentWatchdog::running() const
+{
+    return m_thread.joinable();
+}
+
+void CAgentWatchdog::setTarget(size_t _numSlots)
+{
+    // Submissions of the previous target are not tracked anymore
+    lock_guard<mutex> checkLock(m_checkMutex);
+    m_numPending = 0;
+    m_numLastActive = 0;
+    m_backoff = kMinBackoff;
+    lock_guard<mutex> lock(m_mutex);
+    m_target = _numSlots;
+}
+
+void CAgentWatchdog::addTarget(size_t _numSlots)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_target += _numSlots;
+}
+
+size_t CAgentWatchdog::target() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_target;
+}
+
+bool CAgentWatchdog::check(bool _wait)
+{
+    lock_guard<mutex> checkLock(m_checkMutex);
+    const size_t numTarget{ target() };
+    if (numTarget == 0)
+        return true;
+
+    size_t numActive{ 0 };
+    if (!m_count(numActive))
+        return false;
+    // New active slots are attributed to pending submissions first
+    if (numActive > m_numLastActive)
+        m_numPending -= min(m_numPending, numActive - m_numLastActive);
+    m_numLastActive = numActive;
+    if (numActive >= numTarget)
+    {
+        m_numPending = 0;
+        m_backoff = kMinBackoff;
+        return true;
+    }
+
+    const auto now{ chrono::steady_clock::now() };
+    if (m_numPending > 0 && now >= m_nextReplace)
+    {
+        OLOG(ESeverity::warning) << m_numPending << " submitted DDS agent slots didn't become active within "
+                                 << m_backoff.count() << " ms, submitting them again";
+        m_numPending = 0;
+        m_backoff = min(m_backoff * 2, kMaxBackoff);
+    }
+
+    const size_t numMissing{ (numTarget > numActive + m_numPending) ? numTarget - numActive - m_numPending : 0 };
+    if (numMissing > 0)
+    {
+        OLOG(ESeverity::warning) << "Only " << numActive << " of " << numTarget << " DDS agent slots are active, "
+                                 << m_numPending << " pending, submitting replacement agents";
+        m_numPending += numMissing;
+        m_nextReplace = now + m_backoff;
+    }
+    else
+    {
+        OLOG(ESeverity::info) << "Only " << numActive << " of " << numTarget << " DDS agent slots are active, "
+                              << m_numPending << " pending";
+    }
+
+    const bool success{ m_replace(numMissing, numTarget, _wait) };
+    if (!success)
+    {
+        OLOG(ESeverity::error) << "Failed to replace lost DDS agents";
+    }
+    else if (_wait)
+    {
+        OLOG(ESeverity::info) << "Agent pool is back at " << numTarget << " active slots";
+    }
+    return success;
+}
+
+void CAgentWatchdog::run(chrono::milliseconds _interval)
+{
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            if (m_cv.wait_for(lock, _interval, [this] { return m_stop; }))
+                return;
+        }
+
+        try
+        {
+            // Replacement agents are counted by the next checks, the pool isn't blocked by a wait
+            check(false);
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Agent health check failed: " << _e.what();
+        }
+    }
+}
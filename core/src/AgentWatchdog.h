@@ -0,0 +1,91 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Health tracking of the DDS agent pool.
+//
+
+#ifndef __ODC__AgentWatchdog__
+#define __ODC__AgentWatchdog__
+
+// STD
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Periodically compares the number of active DDS agent slots with the submitted target and replaces
+        /// lost agents.
+        /// \details The target is the number of slots submitted by the control service. A check can also be run
+        /// synchronously before a request which needs the full pool, checks of the thread and of the requests are
+        /// serialized. Slots of replacement agents which are submitted but not active yet are pending and are not
+        /// submitted again. If the pool isn't back at the target after a replacement, pending slots are given up and
+        /// replaced again only after a backoff which doubles with each unsuccessful replacement.
+        class CAgentWatchdog
+        {
+          public:
+            /// \brief Returns the number of active slots. False if the number can't be retrieved.
+            using count_t = std::function<bool(size_t&)>;
+            /// \brief Submits agents for the missing slots, if any, and waits until the target is active if requested.
+            /// False if the submission or the wait failed.
+            using replace_t = std::function<bool(size_t _numMissing, size_t _target, bool _wait)>;
+
+            /// \brief Constructor
+            /// \param [in] _count Function counting the active slots
+            /// \param [in] _replace Function submitting replacement agents
+            CAgentWatchdog(count_t _count, replace_t _replace);
+            ~CAgentWatchdog();
+
+            /// \brief Start checking thread. Restarts the thread if it's already running.
+            /// \param [in] _interval Check interval. 0 doesn't start the thread.
+            void start(const std::chrono::milliseconds& _interval);
+            /// \brief Stop checking thread
+            void stop();
+            /// \brief True if the checking thread is running
+            bool running() const;
+
+            /// \brief Set the target number of active slots. 0 disables the replacement.
+            void setTarget(size_t _numSlots);
+            /// \brief Add slots of a successful submission to the target
+            void addTarget(size_t _numSlots);
+            /// \brief Target number of active slots
+            size_t target() const;
+
+            /// \brief Compare the active slots with the target and replace lost agents
+            /// \param [in] _wait Wait until the pool is at capacity
+            /// \return True if the pool is at capacity after the check, or the replacement was submitted if not waiting
+            bool check(bool _wait = true);
+
+            // Disable copy constructors and assignment operators
+            CAgentWatchdog(const CAgentWatchdog&) = delete;
+            CAgentWatchdog(CAgentWatchdog&&) = delete;
+            CAgentWatchdog& operator=(const CAgentWatchdog&) = delete;
+            CAgentWatchdog& operator=(CAgentWatchdog&&) = delete;
+
+          private:
+            void run(std::chrono::milliseconds _interval);
+
+            count_t m_count;              ///< Counts active slots
+            replace_t m_replace;          ///< Submits replacement agents
+            std::thread m_thread;         ///< Checking thread
+            bool m_stop{ false };         ///< Stop flag of the checking thread
+            size_t m_target{ 0 };         ///< Target number of active slots
+            mutable std::mutex m_mutex;   ///< Protects stop flag and target
+            std::condition_variable m_cv; ///< Signals stop requests
+            std::mutex m_checkMutex;      ///< Serializes checks
+            size_t m_numPending{ 0 };     ///< Submitted slots which are not active yet, protected by m_checkMutex
+            size_t m_numLastActive{ 0 };  ///< Active slots of the last check, protected by m_checkMutex
+            /// Earliest time of the next replacement, protected by m_checkMutex
+            std::chrono::steady_clock::time_point m_nextReplace;
+            std::chrono::milliseconds m_backoff{ kMinBackoff }; ///< Current backoff, protected by m_checkMutex
+
+            static constexpr std::chrono::milliseconds kMinBackoff{ 10000 };  ///< Backoff after the first failure
+            static constexpr std::chrono::milliseconds kMaxBackoff{ 600000 }; ///< Maximum backoff
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__AgentWatchdog__*/
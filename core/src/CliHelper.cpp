@@ -34,6 +34,9 @@ void CCliHelper::addActivateOptions(bpo::options_description& _options,
     _options.add_options()("topo",
                            bpo::value<string>(&_params.m_topologyFile)->default_value(_defaultParams.m_topologyFile),
                            "Topology filepath");
+    _options.add_options()("colocate",
+                           bpo::bool_switch(&_params.m_colocate)->default_value(_defaultParams.m_colocate),
+                           "Shared memory transport for channels whose devices all run on the same host");
 }
 
 void CCliHelper::addUpscaleOptions(bpo::options_description& _options,
@@ -77,6 +80,52 @@ void CCliHelper::addHostOptions(bpo::options_description& _options, const string
     _options.add_options()("host", bpo::value<string>(&_host)->default_value(_defaultHost), "Server address");
 }
 
+void CCliHelper::addConfigDirOptions(bpo::options_description& _options, const string& _defaultDir, string& _dir)
+{
+    _options.add_options()("configdir",
+                           bpo::value<string>(&_dir)->default_value(_defaultDir),
+                           "Directory of configuration snapshots. If empty, the log directory is used.");
+}
+
+void CCliHelper::addAgentWatchdogOptions(bpo::options_description& _options, size_t _defaultInterval, size_t& _interval)
+{
+    _options.add_options()("agent-check-interval",
+                           bpo::value<size_t>(&_interval)->default_value(_defaultInterval),
+                           "Interval of DDS agent health checks in sec. Lost agents are replaced, 0 disables it.");
+}
+
+void CCliHelper::addShmMonitorOptions(bpo::options_description& _options, size_t _defaultInterval, size_t& _interval)
+{
+    _options.add_options()("shm-interval",
+                           bpo::value<size_t>(&_interval)->default_value(_defaultInterval),
+                           "Reporting interval of the odc-shm-monitor helper tasks in ms");
+}
+
+void CCliHelper::addExchangeTimingOptions(bpo::options_description& _options, bool _defaultEnabled, bool& _enabled)
+{
+    _options.add_options()("exchange-timing",
+                           bpo::bool_switch(&_enabled)->default_value(_defaultEnabled),
+                           "Time the exchange of the channel properties during Configure");
+}
+
+void CCliHelper::addCompressionOptions(boost::program_options::options_description& _options,
+                                       const SCompressionParams& _defaultParams,
+                                       SCompressionParams& _params)
+{
+    _options.add_options()("compression",
+                           bpo::value<string>(&_params.m_algorithm)
+                               ->default_value(_defaultParams.m_algorithm)
+                               ->notifier([](const string& _algorithm) {
+                                   if (_algorithm != "none" && _algorithm != "gzip" && _algorithm != "deflate")
+                                       throw bpo::validation_error(
+                                           bpo::validation_error::invalid_option_value, "compression", _algorithm);
+                               }),
+                           "Compression of large gRPC messages: none, gzip or deflate");
+    _options.add_options()("compression-threshold",
+                           bpo::value<size_t>(&_params.m_threshold)->default_value(_defaultParams.m_threshold),
+                           "Size in bytes from which gRPC messages are compressed");
+}
+
 void CCliHelper::addLogOptions(boost::program_options::options_description& _options,
                                const CLogger::SConfig& _defaultConfig,
                                CLogger::SConfig& _config)
@@ -88,6 +137,68 @@ void CCliHelper::addLogOptions(boost::program_options::options_description& _opt
                            "Log severity level");
 }
 
+void CCliHelper::addSamplerOptions(boost::program_options::options_description& _options,
+                                   const SSamplerParams& _defaultParams,
+                                   SSamplerParams& _params)
+{
+    _options.add_options()("sample-rate",
+                           bpo::value<vector<string>>(&_params.m_rateKeys)->multitoken()->composing(),
+                           "Device properties holding a rate, sampled while devices are running");
+    _options.add_options()("sample-counter",
+                           bpo::value<vector<string>>(&_params.m_counterKeys)->multitoken()->composing(),
+                           "Device properties holding a counter, sampled while devices are running");
+    _options.add_options()(
+        "sample-interval",
+        bpo::value<size_t>()
+            ->default_value(_defaultParams.m_interval.count())
+            ->notifier([&_params](size_t _interval) { _params.m_interval = chrono::milliseconds(_interval); }),
+        "Throughput sampling interval in ms");
+    _options.add_options()("sample-jitter",
+                           bpo::value<double>(&_params.m_jitter)->default_value(_defaultParams.m_jitter),
+                           "Maximum relative random deviation of the sampling interval");
+}
+
+void CCliHelper::addStragglerOptions(boost::program_options::options_description& _options,
+                                     const SStragglerParams& _defaultParams,
+                                     SStragglerParams& _params)
+{
+    _options.add_options()(
+        "soft-deadline",
+        bpo::value<size_t>()
+            ->default_value(_defaultParams.m_softDeadline.count())
+            ->notifier([&_params](size_t _deadline) { _params.m_softDeadline = chrono::seconds(_deadline); }),
+        "Soft deadline of state transitions in sec. 0 disables it.");
+    _options.add_options()("stragglers",
+                           bpo::value<string>()->default_value("fail")->notifier([&_params](const string& _policy) {
+                               if (_policy == "isolate")
+                                   _params.m_policy = EStragglerPolicy::isolate;
+                               else if (_policy == "terminate")
+                                   _params.m_policy = EStragglerPolicy::terminate;
+                               else
+                                   _params.m_policy = EStragglerPolicy::fail;
+                           }),
+                           "Handling of devices which miss the soft deadline: fail, isolate or terminate");
+    _options.add_options()("max-stragglers",
+                           bpo::value<double>(&_params.m_maxFraction)->default_value(_defaultParams.m_maxFraction),
+                           "Maximum fraction of devices which can be excluded as stragglers");
+}
+
+void CCliHelper::addRetryOptions(boost::program_options::options_description& _options,
+                                 const SRetryParams& _defaultParams,
+                                 SRetryParams& _params)
+{
+    _options.add_options()(
+        "retries",
+        bpo::value<size_t>(&_params.m_maxRetries)->default_value(_defaultParams.m_maxRetries),
+        "Number of retries of a state transition on the failed devices, at most 10. 0 disables retries.");
+    _options.add_options()(
+        "retry-backoff",
+        bpo::value<size_t>()
+            ->default_value(_defaultParams.m_backoff.count())
+            ->notifier([&_params](size_t _backoff) { _params.m_backoff = chrono::milliseconds(_backoff); }),
+        "Delay before the first retry in ms, doubled for each next retry up to the request timeout");
+}
+
 void CCliHelper::addDeviceOptions(boost::program_options::options_description& _options,
                                   const SDeviceParams& _defaultRecoParams,
                                   SDeviceParams& _recoParams,
@@ -39,9 +39,33 @@ namespace odc
             static void addHostOptions(boost::program_options::options_description& _options,
                                        const std::string& _defaultHost,
                                        std::string& _host);
+            static void addConfigDirOptions(boost::program_options::options_description& _options,
+                                            const std::string& _defaultDir,
+                                            std::string& _dir);
+            static void addAgentWatchdogOptions(boost::program_options::options_description& _options,
+                                                size_t _defaultInterval,
+                                                size_t& _interval);
+            static void addShmMonitorOptions(boost::program_options::options_description& _options,
+                                             size_t _defaultInterval,
+                                             size_t& _interval);
+            static void addExchangeTimingOptions(boost::program_options::options_description& _options,
+                                                 bool _defaultEnabled,
+                                                 bool& _enabled);
+            static void addCompressionOptions(boost::program_options::options_description& _options,
+                                              const SCompressionParams& _defaultParams,
+                                              SCompressionParams& _params);
             static void addLogOptions(boost::program_options::options_description& _options,
                                       const CLogger::SConfig& _defaultConfig,
                                       CLogger::SConfig& _config);
+            static void addSamplerOptions(boost::program_options::options_description& _options,
+                                          const SSamplerParams& _defaultParams,
+                                          SSamplerParams& _params);
+            static void addStragglerOptions(boost::program_options::options_description& _options,
+                                            const SStragglerParams& _defaultParams,
+                                            SStragglerParams& _params);
+            static void addRetryOptions(boost::program_options::options_description& _options,
+                                        const SRetryParams& _defaultParams,
+                                        SRetryParams& _params);
             static void addDeviceOptions(boost::program_options::options_description& _options,
                                          const SDeviceParams& _defaultRecoParams,
                                          SDeviceParams& _recoParams,
@@ -11,6 +11,7 @@
 // STD
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 // BOOST
 #include <boost/algorithm/string.hpp>
 
@@ -63,6 +64,27 @@ namespace odc
             {
                 m_qcDeviceParams = _params;
             }
+            /// \brief Set degraded-mode continuation parameters of all device state changes
+            void setStragglerParams(const odc::core::SStragglerParams& _params)
+            {
+                m_recoDeviceParams.m_stragglers = _params;
+                m_qcDeviceParams.m_stragglers = _params;
+                m_allDeviceParams.m_stragglers = _params;
+            }
+            /// \brief Set the named topology of all device state changes
+            void setTopologyName(const std::string& _name)
+            {
+                m_recoDeviceParams.m_topologyName = _name;
+                m_qcDeviceParams.m_topologyName = _name;
+                m_allDeviceParams.m_topologyName = _name;
+            }
+            /// \brief Set retry parameters of all device state changes
+            void setRetryParams(const odc::core::SRetryParams& _params)
+            {
+                m_recoDeviceParams.m_retry = _params;
+                m_qcDeviceParams.m_retry = _params;
+                m_allDeviceParams.m_retry = _params;
+            }
             void setTimeout(const std::chrono::seconds& _timeout)
             {
                 m_timeout = _timeout;
@@ -78,6 +100,114 @@ namespace odc
                 return m_allDeviceParams;
             }
 
+            /// \brief Parse ".prop key1,key2 [path] [devices]" arguments
+            odc::core::SGetPropertiesParams stringToGetPropertiesParams(const std::string& _keys,
+                                                                       const std::vector<std::string>& _cmds)
+            {
+                odc::core::SGetPropertiesParams params;
+                if (!_keys.empty())
+                    boost::split(params.m_keys, _keys, boost::is_any_of(","));
+                params.m_path = (_cmds.size() > 2) ? _cmds[2] : "";
+                params.m_aggregate = !(_cmds.size() > 3 && _cmds[3] == "devices");
+                return params;
+            }
+
+            /// \brief Parse ".setprop key1=value1,key2=value2 [path] [force]" arguments
+            odc::core::SSetPropertyParams stringToSetPropertyParams(const std::string& _properties,
+                                                                   const std::vector<std::string>& _cmds)
+            {
+                odc::core::SDeviceProperties::properties_t properties;
+                std::vector<std::string> pairs;
+                if (!_properties.empty())
+                    boost::split(pairs, _properties, boost::is_any_of(","));
+                for (const auto& pair : pairs)
+                {
+                    const size_t pos{ pair.find('=') };
+                    if (pos == std::string::npos)
+                    {
+                        OLOG(ESeverity::error) << "Property " << pair << " is not in the key=value format, ignored";
+                        continue;
+                    }
+                    properties.emplace_back(pair.substr(0, pos), pair.substr(pos + 1));
+                }
+                const std::string path{ (_cmds.size() > 2) ? _cmds[2] : "" };
+                return odc::core::SSetPropertyParams(properties, path, _cmds.size() > 3 && _cmds[3] == "force");
+            }
+
+            /// \brief Parse ".saveconfig name [key1=value1,key2=value2 [path]]" arguments
+            odc::core::SSaveConfigParams stringToSaveConfigParams(const std::string& _name,
+                                                                 const std::vector<std::string>& _cmds)
+            {
+                odc::core::SSaveConfigParams params;
+                params.m_name = _name;
+                if (_cmds.size() > 2)
+                {
+                    // Reuse the parser of ".setprop" which expects the properties at position 1
+                    const std::vector<std::string> cmds(_cmds.begin() + 1, _cmds.end());
+                    params.m_entries.push_back(stringToSetPropertyParams(cmds[1], cmds));
+                }
+                return params;
+            }
+
+            /// \brief Parse ".rolling topo [wavesize] [mincapacity]" arguments
+            /// \return False if an argument is invalid
+            bool stringToRollingUpdateParams(const std::vector<std::string>& _cmds, odc::core::SUpdateParams& _params)
+            {
+                _params = odc::core::SUpdateParams((_cmds.size() > 1) ? _cmds[1] : m_upscaleParams.m_topologyFile);
+                uint64_t waveSize{ 1 };
+                if (_cmds.size() > 2 && !stringToUInt(_cmds[2], "wavesize", waveSize))
+                    return false;
+                _params.m_waveSize = waveSize;
+                _params.m_minCapacity = 1.0;
+                return _cmds.size() <= 3 || stringToDouble(_cmds[3], "mincapacity", _params.m_minCapacity);
+            }
+
+            /// \brief Parse a non-negative integer argument
+            /// \return False and log an error if the argument is not a number or out of range
+            static bool stringToUInt(const std::string& _str, const std::string& _name, uint64_t& _value)
+            {
+                try
+                {
+                    size_t pos{ 0 };
+                    // stoull accepts a minus sign and negates the result
+                    if (_str.find('-') == std::string::npos)
+                    {
+                        _value = std::stoull(_str, &pos);
+                        if (pos == _str.size())
+                            return true;
+                    }
+                }
+                catch (std::invalid_argument&)
+                {
+                }
+                catch (std::out_of_range&)
+                {
+                }
+                OLOG(ESeverity::error) << "Invalid " << _name << " " << _str << ", expected a non-negative integer";
+                return false;
+            }
+
+            /// \brief Parse a floating point argument
+            /// \return False and log an error if the argument is not a number or out of range
+            static bool stringToDouble(const std::string& _str, const std::string& _name, double& _value)
+            {
+                try
+                {
+                    size_t pos{ 0 };
+                    _value = std::stod(_str, &pos);
+                    if (pos == _str.size())
+                        return true;
+                }
+                catch (std::invalid_argument&)
+                {
+                }
+                catch (std::out_of_range&)
+                {
+                }
+                OLOG(ESeverity::error) << "Invalid " << _name << " " << _str << ", expected a number";
+                return false;
+            }
+
             void processRequest(const std::string& _cmd)
             {
                 OwnerT* p = reinterpret_cast<OwnerT*>(this);
@@ -104,12 +234,25 @@ namespace odc
                 else if (cmd == ".submit")
                 {
                     OLOG(ESeverity::clean) << "Sending submit request...";
-                    replyString = p->requestSubmit(m_submitParams);
+                    odc::core::SSubmitParams params{ m_submitParams };
+                    params.m_topologyFile = par;
+                    replyString = p->requestSubmit(params);
                 }
                 else if (cmd == ".activate")
                 {
                     OLOG(ESeverity::clean) << "Sending activate request...";
-                    replyString = p->requestActivate(m_activateParams);
+                    // Named topology: ".activate topo name", empty topo "-" removes it
+                    odc::core::SActivateParams params{ m_activateParams };
+                    if (cmds.size() > 2)
+                        params = odc::core::SActivateParams(
+                            (par == "-") ? "" : par, cmds[2], m_activateParams.m_colocate);
+                    replyString = p->requestActivate(params);
+                }
+                else if (cmd == ".use")
+                {
+                    setTopologyName(par);
+                    OLOG(ESeverity::clean) << "Device requests use "
+                                           << (par.empty() ? "all topologies" : "topology " + par);
                 }
                 else if (cmd == ".upscale")
                 {
@@ -121,6 +264,15 @@ namespace odc
                     OLOG(ESeverity::clean) << "Sending downscale request...";
                     replyString = p->requestDownscale(m_downscaleParams);
                 }
+                else if (cmd == ".rolling")
+                {
+                    odc::core::SUpdateParams params;
+                    if (stringToRollingUpdateParams(cmds, params))
+                    {
+                        OLOG(ESeverity::clean) << "Sending rolling update request...";
+                        replyString = p->requestRollingUpdate(params);
+                    }
+                }
                 else if (cmd == ".config")
                 {
                     OLOG(ESeverity::clean) << "Sending configure run request...";
@@ -128,8 +280,14 @@ namespace odc
                 }
                 else if (cmd == ".start")
                 {
-                    OLOG(ESeverity::clean) << "Sending start request...";
-                    replyString = p->requestStart(stringToDeviceParams(par));
+                    odc::core::SDeviceParams params{ stringToDeviceParams(par) };
+                    uint64_t startDelay{ 0 };
+                    if (cmds.size() <= 2 || stringToUInt(cmds[2], "start delay", startDelay))
+                    {
+                        params.m_startDelay = std::chrono::milliseconds(startDelay);
+                        OLOG(ESeverity::clean) << "Sending start request...";
+                        replyString = p->requestStart(params);
+                    }
                 }
                 else if (cmd == ".stop")
                 {
@@ -151,6 +309,55 @@ namespace odc
                     OLOG(ESeverity::clean) << "Sending shutdown request...";
                     replyString = p->requestShutdown();
                 }
+                else if (cmd == ".setprop")
+                {
+                    OLOG(ESeverity::clean) << "Sending set property request...";
+                    replyString = p->requestSetProperty(stringToSetPropertyParams(par, cmds));
+                }
+                else if (cmd == ".saveconfig")
+                {
+                    OLOG(ESeverity::clean) << "Sending save config request...";
+                    replyString = p->requestSaveConfig(stringToSaveConfigParams(par, cmds));
+                }
+                else if (cmd == ".applyconfig")
+                {
+                    OLOG(ESeverity::clean) << "Sending apply config request...";
+                    replyString = p->requestApplyConfig(
+                        odc::core::SApplyConfigParams(par, cmds.size() > 2 && cmds[2] == "force"));
+                }
+                else if (cmd == ".prop")
+                {
+                    OLOG(ESeverity::clean) << "Sending get properties request...";
+                    replyString = p->requestGetProperties(stringToGetPropertiesParams(par, cmds));
+                }
+                else if (cmd == ".topology")
+                {
+                    uint64_t topologyVersion{ 0 };
+                    if (par.empty() || stringToUInt(par, "topology version", topologyVersion))
+                    {
+                        OLOG(ESeverity::clean) << "Sending get topology request...";
+                        replyString = p->requestGetTopology(odc::core::SGetTopologyParams(topologyVersion));
+                    }
+                }
+                else if (cmd == ".metrics")
+                {
+                    OLOG(ESeverity::clean) << "Sending metrics request...";
+                    replyString = p->requestMetrics();
+                }
+                else if (cmd == ".diagnostics")
+                {
+                    OLOG(ESeverity::clean) << "Sending diagnostics request...";
+                    replyString = p->requestDiagnostics();
+                }
+                else if (cmd == ".throughput")
+                {
+                    uint64_t numSamples{ 1 };
+                    if (par.empty() || stringToUInt(par, "number of samples", numSamples))
+                    {
+                        OLOG(ESeverity::clean) << "Sending throughput request...";
+                        replyString = p->requestThroughput(numSamples);
+                    }
+                }
                 else
                 {
                     OLOG(ESeverity::clean) << "Unknown command " << _cmd;
@@ -168,16 +375,39 @@ namespace odc
                                        << "Available commands:" << std::endl
                                        << ".quit - Quit the program." << std::endl
                                        << ".init - Initialization request." << std::endl
-                                       << ".submit - Submit request." << std::endl
-                                       << ".activate - Activate request." << std::endl
+                                       << ".submit [topo] - Submit request. Agents are sized by the topology if given."
+                                       << std::endl
+                                       << ".activate [topo name] - Activate request. Named topologies are activated "
+                                          "side by side, topo \"-\" removes one."
+                                       << std::endl
+                                       << ".use [name] - Restrict device requests to a named topology." << std::endl
                                        << ".upscale - Upscale topology request." << std::endl
                                        << ".downscale - Downscale topology request." << std::endl
+                                       << ".rolling topo [wavesize] [mincapacity] - Rolling update request." << std::endl
                                        << ".config (all|reco|qc) - Configure run request." << std::endl
-                                       << ".start (all|reco|qc) - Start request." << std::endl
+                                       << ".start (all|reco|qc) [delay] - Start request. Optional scheduled start in ms."
+                                       << std::endl
                                        << ".stop (all|reco|qc) - Stop request." << std::endl
                                        << ".reset (all|reco|qc) - Reset request." << std::endl
                                        << ".term (all|reco|qc) - Terminate request." << std::endl
-                                       << ".down - Shutdown request." << std::endl;
+                                       << ".down - Shutdown request." << std::endl
+                                       << ".prop keys [path] [devices] - Get properties request. Comma separated keys."
+                                       << std::endl
+                                       << ".setprop key=value,... [path] [force] - Set properties request. Unchanged "
+                                          "properties are skipped unless forced."
+                                       << std::endl
+                                       << ".saveconfig name [key=value,... [path]] - Save configuration snapshot. "
+                                          "Without properties the applied values are saved."
+                                       << std::endl
+                                       << ".applyconfig name [force] - Apply configuration snapshot." << std::endl
+                                       << ".topology [version] - Get topology request. Nothing is returned if the "
+                                          "version is current."
+                                       << std::endl
+                                       << ".metrics - Metrics request." << std::endl
+                                       << ".diagnostics - Diagnostics request: threads, sessions, requests in flight "
+                                          "and lock contention."
+                                       << std::endl
+                                       << ".throughput [N] - Wait for N throughput samples." << std::endl;
             }
 
           private:
@@ -0,0 +1,140 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "ConfigSnapshot.h"
+// STD
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+// BOOST
+#include <boost/filesystem.hpp>
+
+using namespace odc::core;
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+    void writeUInt32(ofstream& _file, uint32_t _value)
+    {
+        char buffer[4];
+        for (size_t i = 0; i < 4; ++i)
+        {
+            buffer[i] = static_cast<char>((_value >> (8 * i)) & 0xFF);
+        }
+        _file.write(buffer, 4);
+    }
+
+    uint32_t readUInt32(ifstream& _file)
+    {
+        char buffer[4];
+        if (!_file.read(buffer, 4))
+            throw runtime_error("Unexpected end of snapshot");
+        uint32_t value{ 0 };
+        for (size_t i = 0; i < 4; ++i)
+        {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(buffer[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    /// Read a number of elements and check that the rest of the file can hold them before anything is allocated
+    uint32_t readCount(ifstream& _file, uint64_t _minElementSize)
+    {
+        const uint32_t count{ readUInt32(_file) };
+        const auto pos{ _file.tellg() };
+        _file.seekg(0, ios::end);
+        const auto end{ _file.tellg() };
+        _file.seekg(pos);
+        if (pos < 0 || end < pos || count * _minElementSize > static_cast<uint64_t>(end - pos))
+            throw runtime_error("Corrupted snapshot: length exceeds the file size");
+        return count;
+    }
+
+    void writeString(ofstream& _file, const string& _str)
+    {
+        writeUInt32(_file, static_cast<uint32_t>(_str.size()));
+        _file.write(_str.data(), _str.size());
+    }
+
+    string readString(ifstream& _file)
+    {
+        string str(readCount(_file, 1), '\0');
+        if (!str.empty() && !_file.read(&str[0], str.size()))
+            throw runtime_error("Unexpected end of snapshot");
+        return str;
+    }
+} // namespace
+
+const string CConfigSnapshot::kMagic{ "ODCCFG01" };
+
+string CConfigSnapshot::filepath(const string& _dir, const string& _name)
+{
+    if (_dir.empty())
+        throw runtime_error("Directory of configuration snapshots is not set");
+
+    // Names must not escape the snapshot directory
+    const bool valid{ !_name.empty() && _name.front() != '.' && all_of(_name.begin(), _name.end(), [](char _c) {
+                          return isalnum(static_cast<unsigned char>(_c)) || _c == '_' || _c == '-' || _c == '.';
+                      }) };
+    if (!valid)
+        throw runtime_error("Invalid snapshot name \"" + _name + "\"");
+
+    return (bfs::path(_dir) / (_name + ".odccfg")).string();
+}
+
+void CConfigSnapshot::save(const string& _filepath, const entries_t& _entries)
+{
+    const string tmpFilepath{ _filepath + ".tmp" };
+    {
+        ofstream file(tmpFilepath, ios::binary | ios::trunc);
+        if (!file.is_open())
+            throw runtime_error("Can't write snapshot " + tmpFilepath);
+
+        file.write(kMagic.data(), kMagic.size());
+        writeUInt32(file, static_cast<uint32_t>(_entries.size()));
+        for (const auto& entry : _entries)
+        {
+            writeString(file, entry.first);
+            writeUInt32(file, static_cast<uint32_t>(entry.second.size()));
+            for (const auto& property : entry.second)
+            {
+                writeString(file, property.first);
+                writeString(file, property.second);
+            }
+        }
+        if (!file.flush())
+            throw runtime_error("Can't write snapshot " + tmpFilepath);
+    }
+    bfs::rename(tmpFilepath, _filepath);
+}
+
+CConfigSnapshot::entries_t CConfigSnapshot::load(const string& _filepath)
+{
+    ifstream file(_filepath, ios::binary);
+    if (!file.is_open())
+        throw runtime_error("Can't open snapshot " + _filepath);
+
+    string magic(kMagic.size(), '\0');
+    if (!file.read(&magic[0], magic.size()) || magic != kMagic)
+        throw runtime_error(_filepath + " is not an ODC configuration snapshot");
+
+    // An entry holds at least the lengths of the path and of the properties, a property the lengths of key and value
+    const uint64_t kMinEntrySize{ 8 };
+    const uint64_t kMinPropertySize{ 8 };
+    entries_t entries(readCount(file, kMinEntrySize));
+    for (auto& entry : entries)
+    {
+        entry.first = readString(file);
+        entry.second.resize(readCount(file, kMinPropertySize));
+        for (auto& property : entry.second)
+        {
+            property.first = readString(file);
+            property.second = readString(file);
+        }
+    }
+    return entries;
+}
@@ -0,0 +1,47 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Named sets of device property assignments stored on the server.
+//
+
+#ifndef __ODC__ConfigSnapshot__
+#define __ODC__ConfigSnapshot__
+
+// STD
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Reads and writes configuration snapshots
+        /// \details A snapshot is a list of property assignments per path in the topology. It's stored in a compact
+        /// binary file `<name>.odccfg`: magic bytes followed by length prefixed strings, integers are stored little
+        /// endian. Files are written to a temporary file first and renamed, an existing snapshot is never left
+        /// half written.
+        class CConfigSnapshot
+        {
+          public:
+            using properties_t = std::vector<std::pair<std::string, std::string>>;
+            using entries_t = std::vector<std::pair<std::string, properties_t>>; ///< Path and its properties
+
+            /// \brief Magic bytes at the beginning of each snapshot file
+            static const std::string kMagic;
+
+            /// \brief Path of the snapshot file
+            /// \throw std::runtime_error if the directory is empty or the name contains other characters than
+            /// letters, digits, '_', '-' and '.'
+            static std::string filepath(const std::string& _dir, const std::string& _name);
+
+            /// \brief Write a snapshot, an existing snapshot of the same name is replaced
+            /// \throw std::runtime_error if the file can't be written
+            static void save(const std::string& _filepath, const entries_t& _entries);
+            /// \brief Read a snapshot
+            /// \throw std::runtime_error if the file can't be read or is not a snapshot
+            static entries_t load(const std::string& _filepath);
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__ConfigSnapshot__*/
@@ -4,14 +4,35 @@
 
 // ODC
 #include "ControlService.h"
+#include "AgentWatchdog.h"
+#include "ConfigSnapshot.h"
+#include "EventLog.h"
+#include "Executor.h"
 #include "Logger.h"
+#include "RequestWait.h"
+#include "RollingUpdate.h"
+#include "ShmMonitor.h"
+#include "StateRecorder.h"
+#include "StateSubscription.h"
 #include "TimeMeasure.h"
+#include "TopologyComposer.h"
+// STD
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <thread>
 // FairMQ
 #include <fairmq/SDK.h>
 #include <fairmq/sdk/Topology.h>
 // DDS
 #include <dds/Tools.h>
 #include <dds/Topology.h>
+// BOOST
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/regex.hpp>
 
 using namespace odc;
 using namespace odc::core;
@@ -29,13 +50,42 @@ struct CControlService::SImpl
     using DDSSessionPtr_t = std::shared_ptr<dds::tools_api::CSession>;
     using FairMQTopologyPtr_t = std::shared_ptr<fair::mq::sdk::Topology>;
 
+    /// \brief Runtime information about a DDS task reported on activation
+    struct STaskInfo
+    {
+        std::string m_host;         ///< Host where the task is running
+        uint64_t m_agentID{ 0 };    ///< DDS agent ID
+        uint64_t m_slotID{ 0 };     ///< DDS slot ID
+        std::string m_wrkDir;       ///< Working directory of the task
+        uint64_t m_launchTime{ 0 }; ///< Time at which ODC received the task activation from DDS in us since epoch
+    };
+
     SImpl()
+        : m_sampler([this](const vector<string>& _keys, vector<CThroughputSampler::SDeviceValue>& _values) {
+            return fetchSamplerValues(_keys, _values);
+        },
+                    [this]() { cancelSamplerFetch(); })
+        , m_agentWatchdog([this](size_t& _numActive) { return countActiveSlots(_numActive); },
+                          [this](size_t _numMissing, size_t _target, bool _wait) {
+                              return replaceDDSAgents(_numMissing, _target, _wait);
+                          })
     {
         //    fair::Logger::SetConsoleSeverity("debug");
+        // Recorded on the intercom thread in order of arrival
+        m_stateSubscription.addListener(
+            [this](const SStateChange& _change) { m_eventLog.stateChange(m_runID, _change); });
     }
 
     ~SImpl()
     {
+        m_agentWatchdog.stop();
+        m_sampler.stop();
+        m_shmMonitor.stop();
+        m_stateSubscription.stop();
+        // Pending callbacks of this service still use the event log
+        m_executor.wait();
+        m_eventLog.close();
+        removeComposedFiles(true);
     }
 
     void setTimeout(const chrono::seconds& _timeout)
@@ -43,6 +93,53 @@ struct CControlService::SImpl
         m_timeout = _timeout;
     }
 
+    void setSamplerParams(const SSamplerParams& _params)
+    {
+        m_samplerParams = _params;
+    }
+
+    void setEventLogDir(const std::string& _dir)
+    {
+        m_eventLogDir = _dir;
+    }
+
+    void setConfigDir(const std::string& _dir)
+    {
+        m_configDir = _dir;
+    }
+
+    void setAgentCheckInterval(const chrono::milliseconds& _interval)
+    {
+        m_agentCheckInterval = _interval;
+        // Running watchdog is restarted with the new interval, a stopped one is started by the next submission
+        if (m_agentWatchdog.running() || m_agentWatchdog.target() > 0)
+        {
+            m_agentWatchdog.start(m_agentCheckInterval);
+        }
+    }
+
+    void setShmMonitorInterval(const chrono::milliseconds& _interval)
+    {
+        m_shmMonitorInterval = _interval;
+    }
+
+    void setExchangeTiming(bool _enabled)
+    {
+        m_exchangeTiming = _enabled;
+    }
+
+    bool waitForThroughputSample(uint64_t _lastSequence,
+                                 const chrono::milliseconds& _timeout,
+                                 SThroughputSample& _sample)
+    {
+        return m_sampler.waitForSample(_lastSequence, _timeout, _sample);
+    }
+
+    CInFlightOperations& operations()
+    {
+        return m_operations;
+    }
+
     // Core API calls
     // TODO: FIXME: Implement sanity check before calling API
     SReturnValue execInitialize(const SInitializeParams& _params);
@@ -52,6 +149,14 @@ struct CControlService::SImpl
     SReturnValue execShutdown();
 
     SReturnValue execSetProperty(const SSetPropertyParams& _params);
+    SReturnValue execGetProperties(const SGetPropertiesParams& _params);
+    SReturnValue execSaveConfig(const SSaveConfigParams& _params);
+    SReturnValue execApplyConfig(const SApplyConfigParams& _params);
+    SReturnValue execGetTopology(const SGetTopologyParams& _params);
+
+    SReturnValue execGetMetrics();
+    SReturnValue execDiagnostics();
+    SServiceDiagnostics diagnostics() const;
 
     SReturnValue execConfigure(const SDeviceParams& _params);
     SReturnValue execStart(const SDeviceParams& _params);
@@ -60,6 +165,8 @@ struct CControlService::SImpl
     SReturnValue execTerminate(const SDeviceParams& _params);
 
   private:
+    static SReturnDetails::ptr_t createDetails(const SDeviceParams& _params);
+    static TopologyState* topologyState(const SDeviceParams& _params, SReturnDetails::ptr_t _details);
     SReturnValue createReturnValue(bool _success,
                                    const std::string& _msg,
                                    const std::string& _errMsg,
@@ -72,17 +179,97 @@ struct CControlService::SImpl
                              dds::tools_api::STopologyRequest::request_t::EUpdateType _updateType);
     bool waitForNumActiveAgents(size_t _numAgents);
     bool requestCommanderInfo(SCommanderInfoRequest::response_t& _commanderInfo);
+    bool countActiveSlots(size_t& _numActive);
+    bool replaceDDSAgents(size_t _numMissing, size_t _target, bool _wait);
     bool shutdownDDSSession();
     bool createFairMQTopo(const std::string& _topologyFile);
     bool createTopo(const std::string& _topologyFile);
     bool setProperty(const SSetPropertyParams& _params);
+    bool setProperties(const std::vector<SSetPropertyParams>& _params);
+    SDeviceProperties::properties_t changedProperties(const SSetPropertyParams& _params) const;
+    void cacheProperties(const SSetPropertyParams& _params, bool _applied);
+    bool getProperties(const SGetPropertiesParams& _params,
+                       SReturnDetails& _details,
+                       CRequestWait::ptr_t _wait = nullptr);
+    void aggregateProperties(const fair::mq::sdk::GetPropertiesResult& _result,
+                             SPropertyAggregate::container_t& _aggregates) const;
+    std::string deviceIDToPath(const std::string& _deviceID) const;
+    bool deviceIDToTaskID(const std::string& _deviceID, uint64_t& _taskID) const;
+    bool fetchSamplerValues(const std::vector<std::string>& _keys,
+                            std::vector<CThroughputSampler::SDeviceValue>& _values);
+    void cancelSamplerFetch();
+    std::string getTaskHost(uint64_t _taskID) const;
+    void subscribeShmMonitors();
+    bool colocateChannels(const std::string& _path, SColocatedChannel::container_t& _channels);
+    static std::string escapeRegex(const std::string& _str);
+    static bool waitForRequest(CRequestWait::ptr_t _wait,
+                               const chrono::milliseconds& _timeout,
+                               const std::string& _request);
     bool changeState(fair::mq::sdk::TopologyTransition _transition,
                      const std::string& _path,
-                     TopologyState* _topologyState = nullptr);
-    bool changeStateConfigure(const std::string& _path, TopologyState* _topologyState = nullptr);
-    bool changeStateReset(const std::string& _path, TopologyState* _topologyState = nullptr);
+                     TopologyState* _topologyState = nullptr,
+                     const SStragglerParams& _stragglers = SStragglerParams(),
+                     const SRetryParams& _retry = SRetryParams());
+    bool requestChangeState(fair::mq::sdk::TopologyTransition _transition,
+                            const std::string& _path,
+                            const std::chrono::seconds& _timeout,
+                            TopologyState* _topologyState);
+    bool failedDevices(fair::mq::sdk::TopologyTransition _transition,
+                       const std::string& _path,
+                       std::set<uint64_t>& _taskIDs,
+                       size_t& _numSettling);
+    bool changeStateConfigure(const std::string& _path,
+                              TopologyState* _topologyState = nullptr,
+                              const SStragglerParams& _stragglers = SStragglerParams(),
+                              const SRetryParams& _retry = SRetryParams());
+    bool rollingUpdate(const SUpdateParams& _params, SUpdateWave::container_t& _waves);
+    static std::string taskDifferenceRegex(const dds::topology_api::CTopology& _topo,
+                                           const dds::topology_api::CTopology& _reference,
+                                           const std::string& _path = "");
+    bool changeStateReset(const std::string& _path,
+                          TopologyState* _topologyState = nullptr,
+                          const SStragglerParams& _stragglers = SStragglerParams(),
+                          const SRetryParams& _retry = SRetryParams());
+    bool devicesState(const std::string& _path, fair::mq::sdk::DeviceState& _state) const;
+    bool endDevices(const std::string& _path);
+    bool scheduledStart(const SDeviceParams& _params, SReturnDetails::ptr_t _details);
+    static SStartSkew startSkew(const std::map<uint64_t, uint64_t>& _runningTimes, uint64_t _targetTime);
+    void updateLaunchLatencies();
+    static SLaunchLatency::container_t launchLatencies(const std::map<uint64_t, STaskInfo>& _tasks,
+                                                       const std::map<uint64_t, uint64_t>& _stateTimes,
+                                                       uint64_t _requestTime);
+    static uint64_t timestamp();
+    SPropertyLatency::container_t propertyLatencies(uint64_t _bindTime,
+                                                    uint64_t _connectTime,
+                                                    const std::map<uint64_t, uint64_t>& _boundAt,
+                                                    const std::map<uint64_t, uint64_t>& _readyAt) const;
+    static SAgentPlan agentPlan(const SSubmitParams& _params);
+    bool activateNamedTopology(const SActivateParams& _params);
+    bool resolvePath(const SDeviceParams& _params, std::string& _path) const;
+    bool excludeStragglers(fair::mq::sdk::TopologyTransition _transition,
+                           const std::string& _path,
+                           const SStragglerParams& _stragglers);
+    void terminateCollections(const std::set<uint64_t>& _collectionIDs, const chrono::seconds& _timeout);
+    std::string excludedPath(const std::string& _path) const;
+    std::string devicePath(const std::string& _path) const;
+    void updateHelperTasks();
+    static bool isHelperTask(const STopoRuntimeTask& _task);
+    std::set<std::string> excludedCollectionPaths() const;
 
     void fairMQToODCTopologyState(const fair::mq::sdk::TopologyState& _fairmq, TopologyState* _odc);
+    void updateTopologyVersion(const std::string& _topologyFile);
+    void removeComposedFiles(bool _all);
+    static uint64_t nextTopologyVersion();
+    STopologyStructure topologyStructure() const;
+    void omitKnownPaths(uint64_t _knownVersion, SReturnDetails::ptr_t _details) const;
+    static std::string hashFile(const std::string& _filepath);
+    static void logDDSMessage(const SMessageResponseData& _message);
+
+    // Memory accounting
+    void updateTopologyMemoryStats();
+    size_t estimateDDSTopologyMemory() const;
+    size_t estimateFairMQTopologyMemory() const;
+    static size_t estimateTopologyStateMemory(const TopologyState& _state);
 
     // Disable copy constructors and assignment operators
     SImpl(const SImpl&) = delete;
@@ -94,12 +281,54 @@ struct CControlService::SImpl
     DDSSessionPtr_t m_session{ make_shared<CSession>() }; ///< DDS session
     FairMQTopologyPtr_t m_fairmqTopology{ nullptr };      ///< FairMQ topology
     chrono::seconds m_timeout{ 30 };                      ///< Request timeout in sec
-    runID_t m_runID{ 0 };                                 ///< Current external runID for this session
+    std::atomic<runID_t> m_runID{ 0 };                    ///< Current external runID, read by the event log
+    uint64_t m_topologyVersion{ 0 };                      ///< Unique in all partitions and server restarts
+    std::string m_topologyFile;                           ///< Path of the current topology file
+    std::string m_topologyHash;                           ///< Hash of the current topology file content
+    STopologyStructure m_topologyStructure;               ///< Structure snapshot, built on request once per version
+    std::shared_ptr<CMemoryStats> m_memoryStats{ std::make_shared<CMemoryStats>() }; ///< Memory usage per subsystem
+    std::map<uint64_t, STaskInfo> m_taskInfo;             ///< Runtime information of active tasks
+    mutable CTimedMutex m_taskInfoMutex{ "task_info" };   ///< Protects m_taskInfo and the latencies
+    std::atomic<uint64_t> m_activationTime{ 0 };          ///< Time of the last activation request in us since epoch
+    SLaunchLatency::container_t m_launchLatencies;        ///< Launch latency per host and agent of last activation
+    SPropertyLatency::container_t m_propertyLatencies;    ///< Channel property exchange of the last configuration
+    std::string m_eventLogDir;                            ///< Directory of the event logs, empty to disable them
+    std::string m_configDir;                              ///< Directory of the configuration snapshots
+    CTopologyComposer m_composer;                         ///< Named topologies activated side by side
+    std::set<std::string> m_composedFiles;                ///< Temporary files of the combined topologies
+    /// Last successfully applied property values per path selector and key
+    std::map<std::string, std::map<std::string, std::string>> m_propertyCache;
+    CEventLog m_eventLog;                                 ///< Device state changes received by the subscription
+    CStateSubscription m_stateSubscription;               ///< Every state change of the devices of the session
+    /// First state notification of each device, used for the launch latency
+    CStateRecorder m_launchRecorder{ m_stateSubscription };
+    CTaskGroup m_executor;                                ///< Work offloaded from DDS and FairMQ callbacks, shared pool
+    SSamplerParams m_samplerParams;                       ///< Parameters of the throughput sampler
+    CThroughputSampler m_sampler;                         ///< Throughput sampler, runs while devices are running
+    CRequestWait::ptr_t m_samplerWait;                    ///< Wait of the running sampler request
+    std::mutex m_samplerWaitMutex;                        ///< Protects m_samplerWait
+    CShmMonitor m_shmMonitor;                             ///< Shared memory statistics of the helper tasks
+    chrono::milliseconds m_shmMonitorInterval{ 5000 };    ///< Reporting interval of the shared memory helper tasks
+    bool m_exchangeTiming{ false };                       ///< Time the channel property exchange during Configure
+    std::set<uint64_t> m_helperTasks;                     ///< Helper tasks of the topology, not FairMQ devices
+    std::string m_helperPath;                             ///< Regex prefix rejecting the helper tasks, empty if none
+    CDDSRequestStats m_ddsStats;                          ///< Round trips of the requests sent to DDS
+    CInFlightOperations m_operations;                     ///< Requests in flight, used by diagnostics
+    chrono::milliseconds m_agentCheckInterval{ 0 };       ///< Interval of agent health checks, 0 to disable
+    SSubmitParams m_agentSubmitParams;                    ///< Parameters of the last submission, used for replacements
+    /// Protects m_agentSubmitParams
+    mutable CTimedMutex m_agentSubmitMutex{ "agent_submit" };
+    /// Serializes the DDS session requests of the agent watchdog and of the control requests
+    CTimedMutex m_sessionMutex{ "dds_session" };
+    CAgentWatchdog m_agentWatchdog;                       ///< Replaces lost DDS agents
+    std::set<uint64_t> m_excludedCollections;             ///< Straggler collections excluded from state changes
 };
 
 SReturnValue CControlService::SImpl::execInitialize(const SInitializeParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
+    m_sampler.stop();
+    m_excludedCollections.clear();
     // Set current run ID
     m_runID = _params.m_runID;
 
@@ -135,97 +364,443 @@ SReturnValue CControlService::SImpl::execInitialize(const SInitializeParams& _pa
 SReturnValue CControlService::SImpl::execSubmit(const SSubmitParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    size_t allCount = _params.m_numAgents * _params.m_numSlots;
+    SSubmitParams params{ _params };
+    SReturnDetails::ptr_t details;
+    if (!_params.m_topologyFile.empty())
+    {
+        try
+        {
+            details = make_shared<SReturnDetails>();
+            details->m_agentPlan = agentPlan(_params);
+            params.m_numAgents = details->m_agentPlan.m_numAgents;
+            params.m_numSlots = details->m_agentPlan.m_numSlots;
+            OLOG(ESeverity::info) << "Topology " << quoted(_params.m_topologyFile) << " with "
+                                  << details->m_agentPlan.m_numTasks << " tasks requires " << params.m_numAgents
+                                  << " agents with " << params.m_numSlots << " slots";
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Failed to compute agents of the topology: " << _e.what();
+            return createReturnValue(false, "", "Submit failed", measure.duration());
+        }
+    }
+
+    // Agents already lost are replaced first, the wait includes the slots of the previous submissions then
+    const size_t numSlots{ params.m_numAgents * params.m_numSlots };
+    size_t allCount{ numSlots };
+    if (m_agentWatchdog.running() && m_agentWatchdog.check())
+    {
+        allCount += m_agentWatchdog.target();
+    }
     // Submit DDS agents
     // Wait until all agents are active
-    bool success = submitDDSAgents(_params) && waitForNumActiveAgents(allCount);
-    return createReturnValue(success, "Submit done", "Submit failed", measure.duration());
+    bool success = submitDDSAgents(params) && waitForNumActiveAgents(allCount);
+    if (success)
+    {
+        {
+            lock_guard<CTimedMutex> lock(m_agentSubmitMutex);
+            m_agentSubmitParams = params;
+        }
+        m_agentWatchdog.addTarget(numSlots);
+        if (!m_agentWatchdog.running())
+        {
+            m_agentWatchdog.start(m_agentCheckInterval);
+        }
+    }
+    return createReturnValue(success, "Submit done", "Submit failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execActivate(const SActivateParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
+    // Lost agents are replaced before the activation needs their slots
+    if (m_agentWatchdog.running())
+    {
+        m_agentWatchdog.check();
+    }
+    if (!_params.m_topologyName.empty())
+    {
+        // Devices of the other topologies keep running, so does the sampler
+        const bool sampling{ m_sampler.running() };
+        m_sampler.stop();
+        bool success = activateNamedTopology(_params);
+        if (success)
+        {
+            subscribeShmMonitors();
+        }
+        if (sampling)
+        {
+            m_sampler.start(m_samplerParams);
+        }
+        SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+        if (success && _params.m_colocate && !_params.m_topologyFile.empty())
+        {
+            // Only devices of the activated topology are not configured yet
+            success = colocateChannels(m_composer.pathRegex(_params.m_topologyName, ""), details->m_colocatedChannels);
+        }
+        if (success)
+        {
+            // Devices report their first state asynchronously, the reply contains the ones received so far
+            updateLaunchLatencies();
+            lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+            details->m_launchLatencies = m_launchLatencies;
+        }
+        return createReturnValue(success, "Activate done", "Activate failed", measure.duration(), details);
+    }
+
+    m_sampler.stop();
+    // Topology without a name replaces all named topologies
+    m_composer.clear();
+    m_excludedCollections.clear();
     // Activate DDS topology
     // Create fair::mq::sdk::Topology
     bool success = activateDDSTopology(_params.m_topologyFile, STopologyRequest::request_t::EUpdateType::ACTIVATE) &&
                    createTopo(_params.m_topologyFile) && createFairMQTopo(_params.m_topologyFile);
-    return createReturnValue(success, "Activate done", "Activate failed", measure.duration());
+    if (success)
+    {
+        subscribeShmMonitors();
+    }
+    SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+    if (success && _params.m_colocate)
+    {
+        success = colocateChannels("", details->m_colocatedChannels);
+    }
+    if (success)
+    {
+        // Devices report their first state asynchronously, the reply contains the ones received so far
+        updateLaunchLatencies();
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        details->m_launchLatencies = m_launchLatencies;
+    }
+    return createReturnValue(success, "Activate done", "Activate failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execUpdate(const SUpdateParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
+    if (m_agentWatchdog.running())
+    {
+        m_agentWatchdog.check();
+    }
+    if (_params.m_waveSize > 0)
+    {
+        // Devices which are not replaced keep running, so does the sampler
+        const bool sampling{ m_sampler.running() };
+        m_sampler.stop();
+        SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+        bool success = rollingUpdate(_params, details->m_waves);
+        if (success)
+        {
+            subscribeShmMonitors();
+        }
+        if (sampling)
+        {
+            m_sampler.start(m_samplerParams);
+        }
+        return createReturnValue(success, "Update done", "Update failed", measure.duration(), details);
+    }
+
+    m_sampler.stop();
     // Reset devices' state
     // Update DDS topology
     // Create fair::mq::sdk::Topology
     // Configure devices' state
+    // Excluded collections stay excluded, their IDs are stable across updates
     bool success = changeStateReset("") &&
                    activateDDSTopology(_params.m_topologyFile, STopologyRequest::request_t::EUpdateType::UPDATE) &&
                    createTopo(_params.m_topologyFile) && createFairMQTopo(_params.m_topologyFile) &&
                    changeStateConfigure("");
+    if (success)
+    {
+        subscribeShmMonitors();
+    }
     return createReturnValue(success, "Update done", "Update failed", measure.duration());
 }
 
 SReturnValue CControlService::SImpl::execShutdown()
 {
     STimeMeasure<std::chrono::milliseconds> measure;
+    m_sampler.stop();
+    m_composer.clear();
     bool success = shutdownDDSSession();
+    removeComposedFiles(true);
     return createReturnValue(success, "Shutdown done", "Shutdown failed", measure.duration());
 }
 
 SReturnValue CControlService::SImpl::execSetProperty(const SSetPropertyParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    bool success = setProperty(_params);
-    return createReturnValue(success, "ConfigureRun done", "ConfigureRun failed", measure.duration());
+    // Only properties which differ from the last applied values are sent
+    const SSetPropertyParams changed(changedProperties(_params), _params.m_path);
+    bool success{ true };
+    if (!changed.m_properties.empty())
+    {
+        success = setProperty(changed);
+    }
+    const string msg{ "SetProperty done: " + to_string(changed.m_properties.size()) + " of " +
+                      to_string(_params.m_properties.size()) + " properties changed" };
+    return createReturnValue(success, msg, "SetProperty failed", measure.duration());
+}
+
+SReturnValue CControlService::SImpl::execSaveConfig(const SSaveConfigParams& _params)
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    CConfigSnapshot::entries_t entries;
+    if (_params.m_entries.empty())
+    {
+        // Values which are currently applied
+        for (const auto& cached : m_propertyCache)
+        {
+            if (!cached.second.empty())
+                entries.emplace_back(cached.first,
+                                     CConfigSnapshot::properties_t(cached.second.begin(), cached.second.end()));
+        }
+    }
+    else
+    {
+        for (const auto& entry : _params.m_entries)
+        {
+            entries.emplace_back(entry.m_path, entry.m_properties);
+        }
+    }
+
+    bool success(true);
+    try
+    {
+        const string filepath{ CConfigSnapshot::filepath(m_configDir, _params.m_name) };
+        CConfigSnapshot::save(filepath, entries);
+        OLOG(ESeverity::info) << "Configuration snapshot " << quoted(_params.m_name) << " with " << entries.size()
+                              << " paths saved to " << filepath;
+    }
+    catch (exception& _e)
+    {
+        success = false;
+        OLOG(ESeverity::error) << "Save configuration snapshot failed: " << _e.what();
+    }
+    return createReturnValue(success, "SaveConfig done", "SaveConfig failed", measure.duration());
+}
+
+SReturnValue CControlService::SImpl::execApplyConfig(const SApplyConfigParams& _params)
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    CConfigSnapshot::entries_t entries;
+    try
+    {
+        entries = CConfigSnapshot::load(CConfigSnapshot::filepath(m_configDir, _params.m_name));
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Load configuration snapshot failed: " << _e.what();
+        return createReturnValue(false, "", "ApplyConfig failed", measure.duration());
+    }
+
+    vector<SSetPropertyParams> changed;
+    size_t numProperties{ 0 };
+    size_t numChanged{ 0 };
+    for (const auto& entry : entries)
+    {
+        const SSetPropertyParams requested(entry.second, entry.first, _params.m_force);
+        const SSetPropertyParams params(changedProperties(requested), entry.first);
+        numProperties += entry.second.size();
+        numChanged += params.m_properties.size();
+        if (!params.m_properties.empty())
+            changed.push_back(params);
+    }
+
+    const bool success{ changed.empty() || setProperties(changed) };
+    const string msg{ "ApplyConfig " + _params.m_name + " done: " + to_string(numChanged) + " of " +
+                      to_string(numProperties) + " properties changed" };
+    return createReturnValue(success, msg, "ApplyConfig failed", measure.duration());
+}
+
+SReturnValue CControlService::SImpl::execGetProperties(const SGetPropertiesParams& _params)
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+    bool success = getProperties(_params, *details);
+    omitKnownPaths(_params.m_topologyVersion, details);
+    return createReturnValue(success, "GetProperties done", "GetProperties failed", measure.duration(), details);
+}
+
+SReturnValue CControlService::SImpl::execGetTopology(const SGetTopologyParams& _params)
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    if (m_topo == nullptr)
+    {
+        OLOG(ESeverity::error) << "GetTopology requires an active topology";
+        return createReturnValue(false, "", "GetTopology failed", measure.duration());
+    }
+
+    // Client has the snapshot of the current version cached. Versions are unique in all partitions and restarts.
+    if (_params.m_topologyVersion != 0 && _params.m_topologyVersion == m_topologyVersion)
+    {
+        return createReturnValue(true, "GetTopology done: cached version is current", "", measure.duration());
+    }
+
+    bool success{ true };
+    SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+    try
+    {
+        if (m_topologyStructure.m_topologyVersion != m_topologyVersion)
+        {
+            m_topologyStructure = topologyStructure();
+        }
+        details->m_topology = m_topologyStructure;
+    }
+    catch (exception& _e)
+    {
+        success = false;
+        OLOG(ESeverity::error) << "Failed to read the structure of the topology: " << _e.what();
+    }
+    return createReturnValue(success, "GetTopology done", "GetTopology failed", measure.duration(), details);
+}
+
+SReturnValue CControlService::SImpl::execGetMetrics()
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    updateTopologyMemoryStats();
+    SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+    details->m_memoryStats = m_memoryStats->get();
+    details->m_throughput = m_sampler.latest();
+    details->m_shmStats = m_shmMonitor.get();
+    details->m_ddsRequests = m_ddsStats.get();
+    updateLaunchLatencies();
+    {
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        details->m_launchLatencies = m_launchLatencies;
+        details->m_propertyLatencies = m_propertyLatencies;
+    }
+    return createReturnValue(true, "GetMetrics done", "GetMetrics failed", measure.duration(), details);
+}
+
+SReturnValue CControlService::SImpl::execDiagnostics()
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    SReturnDetails::ptr_t details(make_shared<SReturnDetails>());
+    details->m_diagnostics = diagnostics();
+    details->m_process = SProcessDiagnostics::get();
+    return createReturnValue(true, "Diagnostics done", "Diagnostics failed", measure.duration(), details);
+}
+
+SServiceDiagnostics CControlService::SImpl::diagnostics() const
+{
+    SServiceDiagnostics diagnostics;
+    if (m_session->IsRunning())
+    {
+        diagnostics.m_sessionID = to_string(m_session->getSessionID());
+        diagnostics.m_sessionRunning = true;
+    }
+    diagnostics.m_operations = m_operations.get();
+    diagnostics.m_locks = {
+        m_taskInfoMutex.stat(), m_agentSubmitMutex.stat(), m_sessionMutex.stat(), m_eventLog.lockStat()
+    };
+    return diagnostics;
 }
 
 SReturnValue CControlService::SImpl::execConfigure(const SDeviceParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    SReturnDetails::ptr_t details((_params.m_detailed) ? make_shared<SReturnDetails>() : nullptr);
-    bool success = changeStateConfigure(_params.m_path, ((details == nullptr) ? nullptr : &details->m_topologyState));
+    m_sampler.stop();
+    SReturnDetails::ptr_t details(createDetails(_params));
+    string path;
+    bool success = resolvePath(_params, path) &&
+                   changeStateConfigure(path, topologyState(_params, details), _params.m_stragglers, _params.m_retry);
+    {
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        if (success && !m_propertyLatencies.empty())
+        {
+            details = (details == nullptr) ? make_shared<SReturnDetails>() : details;
+            details->m_propertyLatencies = m_propertyLatencies;
+        }
+    }
+    omitKnownPaths(_params.m_topologyVersion, details);
     return createReturnValue(success, "ConfigureRun done", "ConfigureRun failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execStart(const SDeviceParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    SReturnDetails::ptr_t details((_params.m_detailed) ? make_shared<SReturnDetails>() : nullptr);
-    bool success = changeState(fair::mq::sdk::TopologyTransition::Run,
-                               _params.m_path,
-                               ((details == nullptr) ? nullptr : &details->m_topologyState));
+    SReturnDetails::ptr_t details(createDetails(_params));
+    SDeviceParams params{ _params };
+    bool success = resolvePath(_params, params.m_path);
+    if (success && _params.m_startDelay.count() > 0)
+    {
+        success = scheduledStart(params, details);
+    }
+    else if (success)
+    {
+        success = changeState(fair::mq::sdk::TopologyTransition::Run,
+                              excludedPath(params.m_path),
+                              topologyState(_params, details),
+                              _params.m_stragglers,
+                              _params.m_retry);
+    }
+    if (success)
+    {
+        m_sampler.start(m_samplerParams);
+    }
+    omitKnownPaths(_params.m_topologyVersion, details);
     return createReturnValue(success, "Start done", "Start failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execStop(const SDeviceParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    SReturnDetails::ptr_t details((_params.m_detailed) ? make_shared<SReturnDetails>() : nullptr);
-    bool success = changeState(fair::mq::sdk::TopologyTransition::Stop,
-                               _params.m_path,
-                               ((details == nullptr) ? nullptr : &details->m_topologyState));
+    // Sampling is only done while devices are running
+    m_sampler.stop();
+    SReturnDetails::ptr_t details(createDetails(_params));
+    string path;
+    bool success = resolvePath(_params, path) &&
+                   changeState(fair::mq::sdk::TopologyTransition::Stop,
+                               excludedPath(path),
+                               topologyState(_params, details),
+                               _params.m_stragglers,
+                               _params.m_retry);
+    omitKnownPaths(_params.m_topologyVersion, details);
     return createReturnValue(success, "Stop done", "Stop failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execReset(const SDeviceParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    SReturnDetails::ptr_t details((_params.m_detailed) ? make_shared<SReturnDetails>() : nullptr);
-    bool success = changeStateReset(_params.m_path, ((details == nullptr) ? nullptr : &details->m_topologyState));
+    m_sampler.stop();
+    SReturnDetails::ptr_t details(createDetails(_params));
+    string path;
+    bool success = resolvePath(_params, path) &&
+                   changeStateReset(path, topologyState(_params, details), _params.m_stragglers, _params.m_retry);
+    omitKnownPaths(_params.m_topologyVersion, details);
     return createReturnValue(success, "Reset done", "Reset failed", measure.duration(), details);
 }
 
 SReturnValue CControlService::SImpl::execTerminate(const SDeviceParams& _params)
 {
     STimeMeasure<std::chrono::milliseconds> measure;
-    SReturnDetails::ptr_t details((_params.m_detailed) ? make_shared<SReturnDetails>() : nullptr);
-    bool success = changeState(fair::mq::sdk::TopologyTransition::End,
-                               _params.m_path,
-                               ((details == nullptr) ? nullptr : &details->m_topologyState));
+    m_sampler.stop();
+    SReturnDetails::ptr_t details(createDetails(_params));
+    string path;
+    bool success = resolvePath(_params, path) &&
+                   changeState(fair::mq::sdk::TopologyTransition::End,
+                               excludedPath(path),
+                               topologyState(_params, details),
+                               _params.m_stragglers,
+                               _params.m_retry);
+    omitKnownPaths(_params.m_topologyVersion, details);
     return createReturnValue(success, "Terminate done", "Terminate failed", measure.duration(), details);
 }
 
+SReturnDetails::ptr_t CControlService::SImpl::createDetails(const SDeviceParams& _params)
+{
+    // Excluded collections and start skew are always reported if requested
+    return (_params.m_detailed || _params.m_stragglers.enabled() || _params.m_startDelay.count() > 0)
+               ? make_shared<SReturnDetails>()
+               : nullptr;
+}
+
+TopologyState* CControlService::SImpl::topologyState(const SDeviceParams& _params, SReturnDetails::ptr_t _details)
+{
+    return (_params.m_detailed && _details != nullptr) ? &_details->m_topologyState : nullptr;
+}
+
 SReturnValue CControlService::SImpl::createReturnValue(bool _success,
                                                        const std::string& _msg,
                                                        const std::string& _errMsg,
@@ -233,24 +808,53 @@ SReturnValue CControlService::SImpl::createReturnValue(bool _success,
                                                        SReturnDetails::ptr_t _details)
 {
     string sidStr{ to_string(m_session->getSessionID()) };
+    if (_details != nullptr && !_details->m_topologyState.empty())
+    {
+        // Topology states are accounted as long as the reply is alive
+        _details = CMemoryStats::track(
+            m_memoryStats, "replies", estimateTopologyStateMemory(_details->m_topologyState), _details);
+        // Detailed replies of state changes also report the shared memory usage
+        _details->m_shmStats = m_shmMonitor.get();
+    }
+    if (_details != nullptr)
+    {
+        _details->m_excludedCollections = excludedCollectionPaths();
+    }
+    SReturnValue value;
     if (_success)
     {
-        return SReturnValue(EStatusCode::ok, _msg, _execTime, SError(), m_runID, sidStr, _details);
+        value = SReturnValue(EStatusCode::ok, _msg, _execTime, SError(), m_runID, sidStr, _details);
+    }
+    else
+    {
+        value = SReturnValue(EStatusCode::error, "", _execTime, SError(123, _errMsg), m_runID, sidStr, _details);
     }
-    return SReturnValue(EStatusCode::error, "", _execTime, SError(123, _errMsg), m_runID, sidStr, _details);
+    value.m_topologyVersion = m_topologyVersion;
+    value.m_topologyHash = m_topologyHash;
+    return value;
 }
 
 bool CControlService::SImpl::createDDSSession()
 {
     bool success(true);
+    auto trace = m_ddsStats.start("create_session");
     try
     {
-        boost::uuids::uuid sessionID = m_session->create();
+        boost::uuids::uuid sessionID;
+        {
+            lock_guard<CTimedMutex> lock(m_sessionMutex);
+            sessionID = m_session->create();
+        }
+        m_ddsStats.finish(trace, true);
         OLOG(ESeverity::info) << "DDS session created with session ID: " << to_string(sessionID);
+        m_shmMonitor.start(to_string(sessionID));
+        m_eventLog.open(m_eventLogDir, to_string(sessionID));
+        m_stateSubscription.start(to_string(sessionID));
     }
     catch (exception& _e)
     {
         success = false;
+        m_ddsStats.finish(trace, false);
         OLOG(ESeverity::error) << "Failed to create DDS session: " << _e.what();
     }
     return success;
@@ -259,14 +863,23 @@ bool CControlService::SImpl::createDDSSession()
 bool CControlService::SImpl::attachToDDSSession(const std::string& _sessionID)
 {
     bool success(true);
+    auto trace = m_ddsStats.start("attach_session");
     try
     {
-        m_session->attach(_sessionID);
+        {
+            lock_guard<CTimedMutex> lock(m_sessionMutex);
+            m_session->attach(_sessionID);
+        }
+        m_ddsStats.finish(trace, true);
         OLOG(ESeverity::info) << "Attach to a DDS session with session ID: " << _sessionID;
+        m_shmMonitor.start(_sessionID);
+        m_eventLog.open(m_eventLogDir, _sessionID);
+        m_stateSubscription.start(_sessionID);
     }
     catch (exception& _e)
     {
         success = false;
+        m_ddsStats.finish(trace, false);
         OLOG(ESeverity::error) << "Failed to attach to a DDS session: " << _e.what();
     }
     return success;
@@ -274,8 +887,6 @@ bool CControlService::SImpl::attachToDDSSession(const std::string& _sessionID)
 
 bool CControlService::SImpl::submitDDSAgents(const SSubmitParams& _params)
 {
-    bool success(true);
-
     SSubmitRequest::request_t requestInfo;
     requestInfo.m_rms = _params.m_rmsPlugin;
     requestInfo.m_instances = _params.m_numAgents;
@@ -285,71 +896,119 @@ bool CControlService::SImpl::submitDDSAgents(const SSubmitParams& _params)
         requestInfo.m_config = _params.m_configFile;
     }
 
-    std::condition_variable cv;
+    // Error message of the commander is fatal for the submission
+    auto wait = make_shared<CRequestWait>();
+    auto trace = m_ddsStats.start("submit");
 
     SSubmitRequest::ptr_t requestPtr = SSubmitRequest::makeRequest(requestInfo);
 
-    requestPtr->setMessageCallback([&success](const SMessageResponseData& _message) {
+    requestPtr->setMessageCallback([wait, trace, this](const SMessageResponseData& _message) {
+        trace->message();
         if (_message.m_severity == dds::intercom_api::EMsgSeverity::error)
         {
-            success = false;
-            OLOG(ESeverity::error) << "Server reports error: " << _message.m_msg;
-        }
-        else
-        {
-            OLOG(ESeverity::debug) << "Server reports: " << _message.m_msg;
+            wait->error(_message.m_msg);
         }
+        m_executor.post([_message]() { logDDSMessage(_message); });
     });
 
-    requestPtr->setDoneCallback([&cv]() {
-        OLOG(ESeverity::info) << "Agent submission done";
-        cv.notify_all();
+    requestPtr->setDoneCallback([wait, trace, this]() {
+        trace->done();
+        m_executor.post([]() { OLOG(ESeverity::info) << "Agent submission done"; });
+        wait->done();
     });
 
-    m_session->sendRequest<SSubmitRequest>(requestPtr);
-
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lock(mtx);
-    std::cv_status waitStatus = cv.wait_for(lock, m_timeout);
-
-    if (waitStatus == std::cv_status::timeout)
-    {
-        success = false;
-        OLOG(ESeverity::error) << "Timed out waiting for agent submission";
-    }
-    else
     {
-        OLOG(ESeverity::info) << "Agent submission done successfully";
+        lock_guard<CTimedMutex> lock(m_sessionMutex);
+        m_session->sendRequest<SSubmitRequest>(requestPtr);
     }
+
+    const bool success{ waitForRequest(wait, m_timeout, "agent submission") };
+    m_ddsStats.finish(trace, success);
     return success;
 }
 
 bool CControlService::SImpl::requestCommanderInfo(SCommanderInfoRequest::response_t& _commanderInfo)
 {
+    auto trace = m_ddsStats.start("commander_info");
     try
     {
         stringstream ss;
-        m_session->syncSendRequest<SCommanderInfoRequest>(
-            SCommanderInfoRequest::request_t(), _commanderInfo, m_timeout, &ss);
+        {
+            lock_guard<CTimedMutex> lock(m_sessionMutex);
+            m_session->syncSendRequest<SCommanderInfoRequest>(
+                SCommanderInfoRequest::request_t(), _commanderInfo, m_timeout, &ss);
+        }
+        m_ddsStats.finish(trace, true);
         OLOG(ESeverity::info) << ss.str();
         OLOG(ESeverity::debug) << "Commander info: " << _commanderInfo;
         return true;
     }
     catch (exception& _e)
     {
+        m_ddsStats.finish(trace, false);
         OLOG(ESeverity::error) << "Error getting DDS commander info: " << _e.what();
         return false;
     }
 }
 
+bool CControlService::SImpl::countActiveSlots(size_t& _numActive)
+{
+    auto trace = m_ddsStats.start("agent_count");
+    try
+    {
+        stringstream ss;
+        SAgentCountRequest::response_t agentCount;
+        {
+            lock_guard<CTimedMutex> lock(m_sessionMutex);
+            m_session->syncSendRequest<SAgentCountRequest>(SAgentCountRequest::request_t(), agentCount, m_timeout, &ss);
+        }
+        m_ddsStats.finish(trace, true);
+        OLOG(ESeverity::debug) << ss.str();
+        _numActive = agentCount.m_activeSlotsCount;
+        return true;
+    }
+    catch (exception& _e)
+    {
+        m_ddsStats.finish(trace, false);
+        OLOG(ESeverity::error) << "Error getting DDS agent count: " << _e.what();
+        return false;
+    }
+}
+
+bool CControlService::SImpl::replaceDDSAgents(size_t _numMissing, size_t _target, bool _wait)
+{
+    if (_numMissing > 0)
+    {
+        SSubmitParams params;
+        {
+            lock_guard<CTimedMutex> lock(m_agentSubmitMutex);
+            params = m_agentSubmitParams;
+        }
+        if (params.m_numSlots == 0)
+            return false;
+
+        // Replacement agents have the slots of the last submission, the pool may end up larger than the target
+        params.m_numAgents = (_numMissing + params.m_numSlots - 1) / params.m_numSlots;
+        OLOG(ESeverity::info) << "Submitting " << params.m_numAgents << " replacement agents with "
+                              << params.m_numSlots << " slots to " << params.m_rmsPlugin;
+        if (!submitDDSAgents(params))
+            return false;
+    }
+    return !_wait || waitForNumActiveAgents(_target);
+}
+
 bool CControlService::SImpl::waitForNumActiveAgents(size_t _numAgents)
 {
+    auto trace = m_ddsStats.start("wait_for_agents");
     try
     {
+        lock_guard<CTimedMutex> lock(m_sessionMutex);
         m_session->waitForNumAgents<CSession::EAgentState::active>(_numAgents, m_timeout);
+        m_ddsStats.finish(trace, true);
     }
     catch (std::exception& _e)
     {
+        m_ddsStats.finish(trace, false);
         OLOG(ESeverity::error) << "Timeout waiting for DDS agents: " << _e.what();
         return false;
     }
@@ -359,69 +1018,105 @@ bool CControlService::SImpl::waitForNumActiveAgents(size_t _numAgents)
 bool CControlService::SImpl::activateDDSTopology(const string& _topologyFile,
                                                  STopologyRequest::request_t::EUpdateType _updateType)
 {
-    bool success(true);
-
     STopologyRequest::request_t topoInfo;
     topoInfo.m_topologyFile = _topologyFile;
     topoInfo.m_disableValidation = true;
     topoInfo.m_updateType = _updateType;
 
-    std::condition_variable cv;
+    if (_updateType == STopologyRequest::request_t::EUpdateType::ACTIVATE)
+    {
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        m_taskInfo.clear();
+    }
+
+    // Error message of the commander or a failed task is fatal for the activation
+    auto wait = make_shared<CRequestWait>();
+    auto trace = m_ddsStats.start(_updateType == STopologyRequest::request_t::EUpdateType::ACTIVATE
+                                      ? "topology_activate"
+                                      : "topology_update");
 
     STopologyRequest::ptr_t requestPtr = STopologyRequest::makeRequest(topoInfo);
 
-    requestPtr->setMessageCallback([&success](const SMessageResponseData& _message) {
+    requestPtr->setMessageCallback([wait, trace, this](const SMessageResponseData& _message) {
+        trace->message();
         if (_message.m_severity == dds::intercom_api::EMsgSeverity::error)
         {
-            success = false;
-            OLOG(ESeverity::error) << "Server reports error: " << _message.m_msg;
-        }
-        else
-        {
-            OLOG(ESeverity::debug) << "Server reports: " << _message.m_msg;
+            wait->error(_message.m_msg);
         }
+        m_executor.post([_message]() { logDDSMessage(_message); });
     });
 
-    requestPtr->setProgressCallback([](const SProgressResponseData& _progress) {
+    requestPtr->setProgressCallback([wait, trace, this](const SProgressResponseData& _progress) {
+        trace->message();
+        if (_progress.m_errors > 0)
+        {
+            wait->errors(_progress.m_errors,
+                         to_string(_progress.m_errors) + " of " + to_string(_progress.m_total) + " tasks failed");
+        }
         int completed = _progress.m_completed + _progress.m_errors;
         if (completed == _progress.m_total)
         {
-            OLOG(ESeverity::info) << "Activated tasks: " << _progress.m_completed << "\nErrors: " << _progress.m_errors
-                                  << "\nTotal: " << _progress.m_total;
+            m_executor.post([_progress]() {
+                OLOG(ESeverity::info) << "Activated tasks: " << _progress.m_completed
+                                      << "\nErrors: " << _progress.m_errors << "\nTotal: " << _progress.m_total;
+            });
         }
     });
 
-    requestPtr->setDoneCallback([&cv]() {
-        OLOG(ESeverity::info) << "Topology activation done";
-        cv.notify_all();
+    requestPtr->setResponseCallback([trace, this](const STopologyResponseData& _info) {
+        trace->message();
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        if (_info.m_activated)
+        {
+            STaskInfo& task = m_taskInfo[_info.m_taskID];
+            task.m_host = _info.m_host;
+            task.m_agentID = _info.m_agentID;
+            task.m_slotID = _info.m_slotID;
+            task.m_wrkDir = _info.m_wrkDir;
+            task.m_launchTime = timestamp();
+        }
+        else
+        {
+            m_taskInfo.erase(_info.m_taskID);
+        }
     });
 
-    m_session->sendRequest<STopologyRequest>(requestPtr);
-
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lock(mtx);
-    std::cv_status waitStatus = cv.wait_for(lock, m_timeout);
+    requestPtr->setDoneCallback([wait, trace, this]() {
+        trace->done();
+        m_executor.post([]() { OLOG(ESeverity::info) << "Topology activation done"; });
+        wait->done();
+    });
 
-    if (waitStatus == std::cv_status::timeout)
-    {
-        success = false;
-        OLOG(ESeverity::error) << "Timed out waiting for agent submission";
-    }
-    else
+    m_activationTime = timestamp();
+    m_launchRecorder.reset();
     {
-        OLOG(ESeverity::info) << "Topology activation done successfully";
+        lock_guard<CTimedMutex> lock(m_sessionMutex);
+        m_session->sendRequest<STopologyRequest>(requestPtr);
     }
+
+    const bool success{ waitForRequest(wait, m_timeout, "topology activation") };
+    m_ddsStats.finish(trace, success);
     return success;
 }
 
 bool CControlService::SImpl::shutdownDDSSession()
 {
     bool success(true);
+    // Agents of the previous session are not replaced
+    m_agentWatchdog.stop();
+    m_agentWatchdog.setTarget(0);
+    m_shmMonitor.stop();
+    m_stateSubscription.stop();
+    m_eventLog.close();
     try
     {
         if (m_session->IsRunning())
         {
-            m_session->shutdown();
+            auto trace = m_ddsStats.start("shutdown_session");
+            {
+                lock_guard<CTimedMutex> lock(m_sessionMutex);
+                m_session->shutdown();
+            }
             if (m_session->getSessionID() == boost::uuids::nil_uuid())
             {
                 OLOG(ESeverity::info) << "DDS session shutted down";
@@ -431,6 +1126,7 @@ bool CControlService::SImpl::shutdownDDSSession()
                 OLOG(ESeverity::error) << "Failed to shut down DDS session";
                 success = false;
             }
+            m_ddsStats.finish(trace, success);
         }
     }
     catch (exception& _e)
@@ -441,23 +1137,173 @@ bool CControlService::SImpl::shutdownDDSSession()
     return success;
 }
 
-bool CControlService::SImpl::createTopo(const std::string& _topologyFile)
+bool CControlService::SImpl::rollingUpdate(const SUpdateParams& _params, SUpdateWave::container_t& _waves)
 {
+    using fair::mq::sdk::TopologyTransition;
+    const auto updateType{ STopologyRequest::request_t::EUpdateType::UPDATE };
+
+    if (m_topo == nullptr)
+    {
+        OLOG(ESeverity::error) << "Rolling update requires an active topology";
+        return false;
+    }
+
+    unique_ptr<CRollingUpdatePlan> plan;
     try
     {
-        m_topo = make_shared<dds::topology_api::CTopology>(_topologyFile);
+        plan.reset(new CRollingUpdatePlan(m_topologyFile, _params.m_topologyFile));
     }
     catch (exception& _e)
     {
-        OLOG(ESeverity::error) << "Failed to initialize DDS topology: " << _e.what();
+        OLOG(ESeverity::error) << "Rolling update is not possible: " << _e.what();
         return false;
     }
-    return true;
-}
 
-bool CControlService::SImpl::createFairMQTopo(const std::string& _topologyFile)
-{
-    try
+    const size_t numIncoming{ plan->numIncoming() };
+    const size_t numRetiring{ plan->numRetiring() };
+    auto capacity = [&](size_t _added, size_t _removed) {
+        return static_cast<double>(numRetiring - _removed + _added) / numRetiring;
+    };
+
+    // Capacity only depends on the instance counts, so the whole plan is checked before the topology is changed
+    for (size_t added = 0, removed = 0, index = 1; added < numIncoming || removed < numRetiring; ++index)
+    {
+        added = min(numIncoming, added + _params.m_waveSize);
+        removed = min(numRetiring, removed + _params.m_waveSize);
+        if (capacity(added, removed) < _params.m_minCapacity)
+        {
+            OLOG(ESeverity::error) << "Wave " << index << " would reduce capacity to " << capacity(added, removed)
+                                   << ", minimum is " << _params.m_minCapacity;
+            return false;
+        }
+    }
+
+    // New tasks join in the state of the current devices, e.g. Ready between two runs
+    using fair::mq::sdk::DeviceState;
+    DeviceState state;
+    if (!devicesState("", state))
+        return false;
+    if (state != DeviceState::Idle && state != DeviceState::Ready && state != DeviceState::Running)
+    {
+        OLOG(ESeverity::error) << "Rolling update requires devices in Idle, Ready or Running state, they are in "
+                               << state;
+        return false;
+    }
+
+    size_t numAdded{ 0 };
+    size_t numRemoved{ 0 };
+    vector<string> files;
+    bool success{ true };
+
+    while (success && (numAdded < numIncoming || numRemoved < numRetiring))
+    {
+        SUpdateWave wave;
+        wave.m_index = _waves.size() + 1;
+        const size_t nextAdded{ min(numIncoming, numAdded + _params.m_waveSize) };
+        const size_t nextRemoved{ min(numRetiring, numRemoved + _params.m_waveSize) };
+        wave.m_capacity = capacity(nextAdded, nextRemoved);
+
+        // New instances are activated and brought to the state of the current devices first
+        if (nextAdded > numAdded)
+        {
+            STimeMeasure<std::chrono::milliseconds> activateMeasure;
+            files.push_back(plan->write(nextAdded, numRemoved));
+            DDSTopologyPtr_t previous{ m_topo };
+            success = activateDDSTopology(files.back(), updateType) && createTopo(files.back()) &&
+                      createFairMQTopo(files.back());
+            wave.m_activateTime = activateMeasure.duration();
+
+            STimeMeasure<std::chrono::milliseconds> startMeasure;
+            const string path{ (success) ? taskDifferenceRegex(*m_topo, *previous) : "" };
+            success = success && !path.empty() && (state == DeviceState::Idle || changeStateConfigure(path)) &&
+                      (state != DeviceState::Running || changeState(TopologyTransition::Run, path));
+            wave.m_startTime = startMeasure.duration();
+        }
+
+        // Old instances are terminated before DDS removes them
+        if (success && nextRemoved > numRemoved)
+        {
+            STimeMeasure<std::chrono::milliseconds> retireMeasure;
+            files.push_back(plan->write(nextAdded, nextRemoved));
+            const dds::topology_api::CTopology next(files.back());
+            const string path{ taskDifferenceRegex(*m_topo, next) };
+            success = !path.empty() && endDevices(path) && activateDDSTopology(files.back(), updateType) &&
+                      createTopo(files.back()) && createFairMQTopo(files.back());
+            wave.m_retireTime = retireMeasure.duration();
+        }
+
+        wave.m_numAdded = nextAdded - numAdded;
+        wave.m_numRemoved = nextRemoved - numRemoved;
+        wave.m_success = success;
+        _waves.push_back(wave);
+        numAdded = nextAdded;
+        numRemoved = nextRemoved;
+        OLOG(ESeverity::info) << "Rolling update wave " << wave.m_index << ((success) ? " done" : " failed")
+                              << ": added " << wave.m_numAdded << ", removed " << wave.m_numRemoved << ", capacity "
+                              << wave.m_capacity;
+    }
+
+    // The last intermediate topology is equivalent to the target one. Switch to the target file itself.
+    if (success)
+    {
+        success = activateDDSTopology(_params.m_topologyFile, updateType) && createTopo(_params.m_topologyFile) &&
+                  createFairMQTopo(_params.m_topologyFile);
+    }
+
+    // Keep the intermediate topology if the update stopped on it
+    for (const auto& file : files)
+    {
+        boost::system::error_code ec;
+        if (file != m_topologyFile)
+            boost::filesystem::remove(file, ec);
+    }
+    return success;
+}
+
+string CControlService::SImpl::taskDifferenceRegex(const dds::topology_api::CTopology& _topo,
+                                                   const dds::topology_api::CTopology& _reference,
+                                                   const string& _path)
+{
+    // Paths of the tasks of _topo matching _path which don't exist in _reference.
+    // Task IDs are derived from the task path, so they are stable across updates.
+    set<uint64_t> referenceIDs;
+    auto referenceTasks = _reference.getRuntimeTaskIterator();
+    for (auto it = referenceTasks.first; it != referenceTasks.second; ++it)
+    {
+        referenceIDs.insert(it->first);
+    }
+
+    const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+    string regex;
+    auto tasks = _topo.getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        if (referenceIDs.count(it->first) > 0 || !boost::regex_match(it->second.m_taskPath, pathRegex))
+            continue;
+        regex += (regex.empty() ? "(" : "|") + escapeRegex(it->second.m_taskPath);
+    }
+    return (regex.empty()) ? regex : regex + ")";
+}
+
+bool CControlService::SImpl::createTopo(const std::string& _topologyFile)
+{
+    try
+    {
+        m_topo = make_shared<dds::topology_api::CTopology>(_topologyFile);
+        updateHelperTasks();
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Failed to initialize DDS topology: " << _e.what();
+        return false;
+    }
+    updateTopologyMemoryStats();
+    return true;
+}
+
+bool CControlService::SImpl::createFairMQTopo(const std::string& _topologyFile)
+{
+    try
     {
         m_fairmqTopology.reset();
         fair::mq::sdk::DDSEnv env;
@@ -465,131 +1311,1428 @@ bool CControlService::SImpl::createFairMQTopo(const std::string& _topologyFile)
         session.StopOnDestruction(false);
         fair::mq::sdk::DDSTopo topo(fair::mq::sdk::DDSTopo::Path(_topologyFile), env);
         m_fairmqTopology = make_shared<fair::mq::sdk::Topology>(topo, session);
+        updateTopologyVersion(_topologyFile);
+        // New devices reply with their current state
+        m_stateSubscription.subscribe();
+    }
+    catch (exception& _e)
+    {
+        m_fairmqTopology = nullptr;
+        OLOG(ESeverity::error) << "Failed to initialize FairMQ topology: " << _e.what();
+    }
+    updateTopologyMemoryStats();
+    return m_fairmqTopology != nullptr;
+}
+
+bool CControlService::SImpl::changeState(fair::mq::sdk::TopologyTransition _transition,
+                                         const string& _path,
+                                         TopologyState* _topologyState,
+                                         const SStragglerParams& _stragglers,
+                                         const SRetryParams& _retry)
+{
+    if (m_fairmqTopology == nullptr)
+        return false;
+
+    if (_transition == fair::mq::sdk::TopologyTransition::ResetDevice ||
+        _transition == fair::mq::sdk::TopologyTransition::End)
+    {
+        // Devices might drop properties set at runtime
+        m_propertyCache.clear();
+    }
+
+    // Soft deadline replaces the request timeout
+    const chrono::seconds timeout{ (_stragglers.enabled()) ? _stragglers.m_softDeadline : m_timeout };
+    TopologyState state;
+    TopologyState* statePtr{ (_topologyState != nullptr) ? &state : nullptr };
+    bool success{ requestChangeState(_transition, _path, timeout, statePtr) };
+
+    // Each backoff is capped by the request timeout, no retry starts once the retries took another request timeout
+    const size_t maxRetries{ min(_retry.m_maxRetries, kMaxRetries) };
+    const auto retryDeadline{ chrono::steady_clock::now() + m_timeout };
+    for (size_t retry = 1; !success && retry <= maxRetries; ++retry)
+    {
+        // Devices which are still in transition get the time of the backoff to settle
+        const chrono::milliseconds backoff{ min<chrono::milliseconds>(
+            m_timeout, _retry.m_backoff * (1 << min<size_t>(retry - 1, 16))) };
+        if (chrono::steady_clock::now() + backoff > retryDeadline)
+        {
+            OLOG(ESeverity::warning) << "Retries of " << _transition << " stopped after " << (retry - 1)
+                                     << " retries, total retry time is limited to " << m_timeout.count() << " sec";
+            break;
+        }
+        this_thread::sleep_for(backoff);
+
+        set<uint64_t> taskIDs;
+        size_t numSettling{ 0 };
+        if (!failedDevices(_transition, _path, taskIDs, numSettling))
+            break;
+        // Only the reply was lost, all devices reached the target state
+        if (taskIDs.empty() && numSettling == 0)
+        {
+            success = true;
+            break;
+        }
+        if (taskIDs.empty())
+        {
+            OLOG(ESeverity::warning) << "Waiting for " << numSettling << " devices in transition " << _transition
+                                     << ", retry " << retry << " of " << _retry.m_maxRetries;
+            continue;
+        }
+
+        OLOG(ESeverity::warning) << "Retrying " << _transition << " on " << taskIDs.size() << " failed devices, "
+                                 << numSettling << " devices still in transition, retry " << retry << " of "
+                                 << _retry.m_maxRetries;
+
+        string path;
+        for (auto taskID : taskIDs)
+        {
+            path += (path.empty() ? "(" : "|") + escapeRegex(m_topo->getRuntimeTaskById(taskID).m_taskPath);
+        }
+        TopologyState retried;
+        // Devices in transition are checked again by the next retry
+        success = requestChangeState(_transition, path + ")", timeout, (statePtr != nullptr) ? &retried : nullptr) &&
+                  numSettling == 0;
+
+        // Replace the states of the retried devices
+        for (const auto& status : retried)
+        {
+            auto it = find_if(state.begin(), state.end(), [&status](const SDeviceStatus& _status) {
+                return _status.m_status.taskId == status.m_status.taskId;
+            });
+            if (it != state.end())
+                *it = status;
+            else
+                state.push_back(status);
+        }
+    }
+
+    if (_topologyState != nullptr)
+    {
+        _topologyState->insert(_topologyState->end(), state.begin(), state.end());
+    }
+
+    if (!success && _stragglers.enabled() && _stragglers.m_policy != EStragglerPolicy::fail)
+    {
+        success = excludeStragglers(_transition, _path, _stragglers);
+    }
+
+    return success;
+}
+
+bool CControlService::SImpl::requestChangeState(fair::mq::sdk::TopologyTransition _transition,
+                                                const string& _path,
+                                                const chrono::seconds& _timeout,
+                                                TopologyState* _topologyState)
+{
+    bool success(false);
+    try
+    {
+        auto wait = make_shared<CRequestWait>();
+        // Converted state is owned by the callback as well, it's only used if the wait didn't time out
+        auto state = make_shared<TopologyState>();
+        const bool convert{ _topologyState != nullptr };
+        m_eventLog.transition(m_runID, _transition);
+        m_fairmqTopology->AsyncChangeState(
+            _transition,
+            devicePath(_path),
+            _timeout,
+            [wait, state, convert, this](std::error_code _ec, fair::mq::sdk::TopologyState _state) {
+                // Aggregation and conversion of the state are done by the executor.
+                // FairMQ thread returns immediately.
+                m_executor.post([wait, state, convert, _ec, _state, this]() {
+                    OLOG(ESeverity::info) << "Change transition result: " << _ec.message();
+                    if (convert)
+                        fairMQToODCTopologyState(_state, state.get());
+                    if (_ec)
+                    {
+                        wait->error(_ec.message());
+                        return;
+                    }
+                    try
+                    {
+                        fair::mq::sdk::AggregateState(_state);
+                        wait->done();
+                    }
+                    catch (exception& _e)
+                    {
+                        wait->error(_e.what());
+                    }
+                });
+            });
+
+        stringstream request;
+        request << "change state " << _transition;
+        success = waitForRequest(wait, _timeout, request.str());
+        if (convert && !wait->timedOut())
+        {
+            _topologyState->insert(_topologyState->end(), state->begin(), state->end());
+        }
     }
     catch (exception& _e)
     {
-        m_fairmqTopology = nullptr;
-        OLOG(ESeverity::error) << "Failed to initialize FairMQ topology: " << _e.what();
+        success = false;
+        OLOG(ESeverity::error) << "Change state failed: " << _e.what();
+    }
+    return success;
+}
+
+bool CControlService::SImpl::failedDevices(fair::mq::sdk::TopologyTransition _transition,
+                                           const string& _path,
+                                           set<uint64_t>& _taskIDs,
+                                           size_t& _numSettling)
+{
+    using fair::mq::sdk::DeviceState;
+    using fair::mq::sdk::TopologyTransition;
+    // A transition can only be requested again from the state it starts from
+    static const map<TopologyTransition, DeviceState> sourceStates{
+        { TopologyTransition::InitDevice, DeviceState::Idle },
+        { TopologyTransition::CompleteInit, DeviceState::InitializingDevice },
+        { TopologyTransition::Bind, DeviceState::Initialized },
+        { TopologyTransition::Connect, DeviceState::Bound },
+        { TopologyTransition::InitTask, DeviceState::DeviceReady },
+        { TopologyTransition::Run, DeviceState::Ready },
+        { TopologyTransition::Stop, DeviceState::Running },
+        { TopologyTransition::ResetTask, DeviceState::Ready },
+        { TopologyTransition::ResetDevice, DeviceState::DeviceReady },
+        { TopologyTransition::End, DeviceState::Idle }
+    };
+
+    const auto expected = fair::mq::sdk::expectedState.find(_transition);
+    const auto source = sourceStates.find(_transition);
+    if (expected == fair::mq::sdk::expectedState.end() || source == sourceStates.end() || m_topo == nullptr)
+        return false;
+
+    try
+    {
+        const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+        const auto currentState{ m_fairmqTopology->GetCurrentState() };
+        for (const auto& status : currentState)
+        {
+            if (status.state == expected->second || m_helperTasks.count(status.taskId) > 0 ||
+                !boost::regex_match(m_topo->getRuntimeTaskById(status.taskId).m_taskPath, pathRegex))
+                continue;
+
+            // Error state can only be left by a restart of the device
+            if (status.state == fair::mq::sdk::DeviceState::Error)
+            {
+                OLOG(ESeverity::error) << "Task " << status.taskId << " is in Error state, " << _transition
+                                       << " can't be retried";
+                return false;
+            }
+            // Transition is still running, e.g. Binding, or the device hasn't reported the new state yet
+            if (status.state != source->second)
+            {
+                ++_numSettling;
+                continue;
+            }
+            _taskIDs.insert(status.taskId);
+        }
+        return true;
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Failed to select devices for the retry: " << _e.what();
+    }
+    return false;
+}
+
+bool CControlService::SImpl::changeStateConfigure(const string& _path,
+                                                  TopologyState* _topologyState,
+                                                  const SStragglerParams& _stragglers,
+                                                  const SRetryParams& _retry)
+{
+    // Collections excluded by a transition are skipped by the following ones
+    auto changeStep = [&](fair::mq::sdk::TopologyTransition _transition) {
+        return changeState(_transition, excludedPath(_path), _topologyState, _stragglers, _retry);
+    };
+    if (!changeStep(fair::mq::sdk::TopologyTransition::InitDevice) ||
+        !changeStep(fair::mq::sdk::TopologyTransition::CompleteInit))
+        return false;
+
+    // Channel addresses are published as DDS properties on Bind and read on Connect.
+    // If requested, arrival times of the Bound and DeviceReady notifications time the exchange.
+    unique_ptr<CStateRecorder> recorder;
+    if (m_exchangeTiming)
+    {
+        const set<fair::mq::State> states{ fair::mq::sdk::DeviceState::Bound, fair::mq::sdk::DeviceState::DeviceReady };
+        recorder.reset(new CStateRecorder(m_stateSubscription, states));
+    }
+
+    const uint64_t bindTime{ timestamp() };
+    bool success{ changeStep(fair::mq::sdk::TopologyTransition::Bind) };
+    const uint64_t connectTime{ timestamp() };
+    success = success && changeStep(fair::mq::sdk::TopologyTransition::Connect);
+
+    if (success && recorder != nullptr)
+    {
+        const auto boundTimes{ recorder->get(fair::mq::sdk::DeviceState::Bound) };
+        // Only devices which went through Bound in this configuration
+        map<uint64_t, uint64_t> readyTimes;
+        for (const auto& v : recorder->get(fair::mq::sdk::DeviceState::DeviceReady))
+        {
+            if (boundTimes.count(v.first) > 0)
+                readyTimes.insert(v);
+        }
+        auto latencies{ propertyLatencies(bindTime, connectTime, boundTimes, readyTimes) };
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        m_propertyLatencies = move(latencies);
+    }
+    return success && changeStep(fair::mq::sdk::TopologyTransition::InitTask);
+}
+
+SPropertyLatency::container_t CControlService::SImpl::propertyLatencies(uint64_t _bindTime,
+                                                                        uint64_t _connectTime,
+                                                                        const map<uint64_t, uint64_t>& _boundAt,
+                                                                        const map<uint64_t, uint64_t>& _readyAt) const
+{
+    SPropertyLatency::container_t latencies;
+    if (m_topo == nullptr)
+        return latencies;
+
+    auto msec = [](uint64_t _from, uint64_t _to) {
+        return (_to > _from) ? static_cast<double>(_to - _from) / 1000. : 0.;
+    };
+
+    // Values of collection scoped properties are only exchanged within a collection instance.
+    // Key: property name, collection ID or 0 for global properties.
+    using key_t = pair<string, uint64_t>;
+    map<key_t, uint64_t> publishTimes;
+    map<string, size_t> numWriters;
+    vector<pair<key_t, uint64_t>> readers;
+    auto tasks = m_topo->getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        const uint64_t taskID{ it->first };
+        for (const auto& v : it->second.m_task->getProperties())
+        {
+            const auto& property{ v.second };
+            const string& name{ property->getName() };
+            if (name.compare(0, kChannelPropertyPrefix.size(), kChannelPropertyPrefix) != 0)
+                continue;
+
+            const bool collectionScope{ property->getScopeType() == EScopeType::COLLECTION };
+            const key_t key{ name, collectionScope ? it->second.m_taskCollectionId : 0 };
+            const auto access{ property->getAccessType() };
+            const auto bound{ _boundAt.find(taskID) };
+            if (access != EPropertyAccessType::READ && bound != _boundAt.end())
+            {
+                numWriters[name]++;
+                publishTimes[key] = max(publishTimes[key], bound->second);
+            }
+            if (access != EPropertyAccessType::WRITE)
+            {
+                readers.emplace_back(key, taskID);
+            }
+        }
+    }
+
+    // Exchange times per property name and host of the reader, empty host for all hosts
+    map<pair<string, string>, vector<double>> samples;
+    map<string, uint64_t> lastPublishTimes;
+    for (const auto& reader : readers)
+    {
+        const auto published{ publishTimes.find(reader.first) };
+        const auto ready{ _readyAt.find(reader.second) };
+        if (published == publishTimes.end() || ready == _readyAt.end())
+            continue;
+
+        const string& name{ reader.first.first };
+        const double exchange{ msec(max(published->second, _connectTime), ready->second) };
+        samples[make_pair(name, string())].push_back(exchange);
+        samples[make_pair(name, getTaskHost(reader.second))].push_back(exchange);
+        lastPublishTimes[name] = max(lastPublishTimes[name], published->second);
+    }
+
+    for (auto& v : samples)
+    {
+        auto& times{ v.second };
+        sort(times.begin(), times.end());
+        // Nearest rank percentile
+        auto percentile = [&times](double _fraction) {
+            const size_t rank{ static_cast<size_t>(ceil(_fraction * times.size())) };
+            return times[min(times.size() - 1, (rank > 0) ? rank - 1 : 0)];
+        };
+
+        SPropertyLatency latency;
+        latency.m_property = v.first.first;
+        latency.m_host = v.first.second;
+        latency.m_numWriters = numWriters[latency.m_property];
+        latency.m_numReaders = times.size();
+        latency.m_publishTime = msec(_bindTime, lastPublishTimes[latency.m_property]);
+        latency.m_median = percentile(0.5);
+        latency.m_p90 = percentile(0.9);
+        latency.m_max = times.back();
+        latencies.push_back(latency);
+        if (latency.m_host.empty())
+        {
+            OLOG(ESeverity::info) << "Exchange of " << latency.m_property << " (" << latency.m_numWriters
+                                  << " writers, " << latency.m_numReaders << " readers): published after "
+                                  << latency.m_publishTime << " ms, median " << latency.m_median << " ms, max "
+                                  << latency.m_max << " ms";
+        }
+    }
+    return latencies;
+}
+
+bool CControlService::SImpl::changeStateReset(const string& _path,
+                                              TopologyState* _topologyState,
+                                              const SStragglerParams& _stragglers,
+                                              const SRetryParams& _retry)
+{
+    auto changeStep = [&](fair::mq::sdk::TopologyTransition _transition) {
+        return changeState(_transition, excludedPath(_path), _topologyState, _stragglers, _retry);
+    };
+    return changeStep(fair::mq::sdk::TopologyTransition::ResetTask) &&
+           changeStep(fair::mq::sdk::TopologyTransition::ResetDevice);
+}
+
+bool CControlService::SImpl::devicesState(const string& _path, fair::mq::sdk::DeviceState& _state) const
+{
+    if (m_topo == nullptr || m_fairmqTopology == nullptr)
+        return false;
+
+    try
+    {
+        const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+        fair::mq::sdk::TopologyState selected;
+        for (const auto& status : m_fairmqTopology->GetCurrentState())
+        {
+            if (m_helperTasks.count(status.taskId) == 0 &&
+                boost::regex_match(m_topo->getRuntimeTaskById(status.taskId).m_taskPath, pathRegex))
+                selected.push_back(status);
+        }
+        if (selected.empty())
+        {
+            OLOG(ESeverity::error) << "No devices match " << _path;
+            return false;
+        }
+        // Throws if the devices are in different states
+        _state = fair::mq::sdk::AggregateState(selected);
+        return true;
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Failed to read the state of the devices: " << _e.what();
+    }
+    return false;
+}
+
+bool CControlService::SImpl::endDevices(const string& _path)
+{
+    using fair::mq::sdk::DeviceState;
+    using fair::mq::sdk::TopologyTransition;
+    if (m_topo == nullptr || m_fairmqTopology == nullptr)
+        return false;
+
+    // Each step moves the devices of one state to the next one, so devices are wound down from the state they are in
+    static const vector<pair<DeviceState, TopologyTransition>> steps{
+        { DeviceState::Running, TopologyTransition::Stop },
+        { DeviceState::Ready, TopologyTransition::ResetTask },
+        { DeviceState::DeviceReady, TopologyTransition::ResetDevice },
+        { DeviceState::Idle, TopologyTransition::End }
+    };
+    size_t numSkipped{ 0 };
+    for (const auto& step : steps)
+    {
+        string path;
+        numSkipped = 0;
+        try
+        {
+            const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+            for (const auto& status : m_fairmqTopology->GetCurrentState())
+            {
+                const string& taskPath{ m_topo->getRuntimeTaskById(status.taskId).m_taskPath };
+                if (m_helperTasks.count(status.taskId) > 0 || !boost::regex_match(taskPath, pathRegex))
+                    continue;
+                if (status.state == step.first)
+                    path += (path.empty() ? "(" : "|") + escapeRegex(taskPath);
+                else if (status.state != DeviceState::Exiting)
+                    ++numSkipped;
+            }
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Failed to select devices for " << step.second << ": " << _e.what();
+            return false;
+        }
+        if (!path.empty() && !changeState(step.second, path + ")"))
+            return false;
+    }
+
+    // Devices in other states, e.g. Error, can't be wound down and are killed by DDS
+    if (numSkipped > 0)
+    {
+        OLOG(ESeverity::warning) << numSkipped << " devices could not be ended";
+    }
+    return true;
+}
+
+bool CControlService::SImpl::scheduledStart(const SDeviceParams& _params, SReturnDetails::ptr_t _details)
+{
+    // Devices which honor the property delay the start of processing until the target time
+    const string path{ excludedPath(_params.m_path) };
+    const auto now{ chrono::system_clock::now().time_since_epoch() };
+    const uint64_t targetTime{ static_cast<uint64_t>(
+        chrono::duration_cast<chrono::milliseconds>(now + _params.m_startDelay).count()) };
+    if (!setProperty(SSetPropertyParams(kStartTimeProperty, to_string(targetTime), path)))
+        return false;
+
+    // Only the devices of the path go through Running during the transition
+    CStateRecorder recorder(m_stateSubscription, { fair::mq::sdk::DeviceState::Running });
+    const bool success{ changeState(fair::mq::sdk::TopologyTransition::Run,
+                                    path,
+                                    topologyState(_params, _details),
+                                    _params.m_stragglers,
+                                    _params.m_retry) };
+
+    _details->m_startSkew = startSkew(recorder.get(fair::mq::sdk::DeviceState::Running), targetTime);
+    const SStartSkew& skew{ _details->m_startSkew };
+    OLOG(ESeverity::info) << "Start skew of " << skew.m_numDevices << " devices: median " << skew.m_median
+                          << " ms, p99 " << skew.m_p99 << " ms, max " << skew.m_max << " ms; " << skew.m_numLate
+                          << " devices were late";
+    return success;
+}
+
+SStartSkew CControlService::SImpl::startSkew(const map<uint64_t, uint64_t>& _runningTimes, uint64_t _targetTime)
+{
+    SStartSkew skew;
+    skew.m_targetTime = _targetTime;
+    skew.m_numDevices = _runningTimes.size();
+    if (_runningTimes.empty())
+        return skew;
+
+    // Delay of each notification relative to the target time in ms, devices which were Running in time start on time
+    const uint64_t targetTime{ _targetTime * 1000 };
+    vector<double> delays;
+    delays.reserve(_runningTimes.size());
+    for (const auto& v : _runningTimes)
+    {
+        delays.push_back((v.second > targetTime) ? static_cast<double>(v.second - targetTime) / 1000. : 0.);
+    }
+    sort(delays.begin(), delays.end());
+
+    // Nearest rank percentile
+    auto percentile = [&delays](double _fraction) {
+        const size_t rank{ static_cast<size_t>(ceil(_fraction * delays.size())) };
+        return delays[min(delays.size() - 1, (rank > 0) ? rank - 1 : 0)];
+    };
+    skew.m_median = percentile(0.5);
+    skew.m_p90 = percentile(0.9);
+    skew.m_p99 = percentile(0.99);
+    skew.m_max = delays.back();
+    skew.m_numLate = count_if(delays.begin(), delays.end(), [](double _delay) { return _delay > 0.; });
+    return skew;
+}
+
+void CControlService::SImpl::updateLaunchLatencies()
+{
+    // Tasks started by the last activation, tasks kept by an update have an earlier launch time
+    map<uint64_t, STaskInfo> launched;
+    {
+        lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+        for (const auto& v : m_taskInfo)
+        {
+            // Helper tasks never report a state
+            if (v.second.m_launchTime >= m_activationTime && m_helperTasks.count(v.first) == 0)
+                launched.insert(v);
+        }
+    }
+
+    // New devices reply to the subscription with their current state, devices which didn't reply yet are not counted
+    auto latencies{ launchLatencies(launched, m_launchRecorder.first(), m_activationTime) };
+    lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+    m_launchLatencies = move(latencies);
+}
+
+SLaunchLatency::container_t CControlService::SImpl::launchLatencies(const map<uint64_t, STaskInfo>& _tasks,
+                                                                    const map<uint64_t, uint64_t>& _stateTimes,
+                                                                    uint64_t _requestTime)
+{
+    auto msec = [_requestTime](uint64_t _time) {
+        return (_time > _requestTime) ? static_cast<double>(_time - _requestTime) / 1000. : 0.;
+    };
+
+    // Key of the aggregate: scope, name. Value: launch and state times in ms.
+    map<pair<string, string>, pair<vector<double>, vector<double>>> samples;
+    for (const auto& task : _tasks)
+    {
+        const auto state{ _stateTimes.find(task.first) };
+        for (const auto& key : { make_pair(string("host"), task.second.m_host),
+                                 make_pair(string("agent"), to_string(task.second.m_agentID)) })
+        {
+            auto& sample = samples[key];
+            sample.first.push_back(msec(task.second.m_launchTime));
+            if (state != _stateTimes.end())
+                sample.second.push_back(msec(state->second));
+        }
+    }
+
+    // Median with nearest rank, times must be sorted
+    auto median = [](const vector<double>& _times) {
+        return (_times.empty()) ? 0. : _times[(_times.size() - 1) / 2];
+    };
+
+    SLaunchLatency::container_t latencies;
+    for (auto& v : samples)
+    {
+        auto& launchTimes{ v.second.first };
+        auto& stateTimes{ v.second.second };
+        sort(launchTimes.begin(), launchTimes.end());
+        sort(stateTimes.begin(), stateTimes.end());
+
+        SLaunchLatency latency;
+        latency.m_scope = v.first.first;
+        latency.m_name = v.first.second;
+        latency.m_numTasks = launchTimes.size();
+        latency.m_numReported = stateTimes.size();
+        latency.m_launchMedian = median(launchTimes);
+        latency.m_launchMax = launchTimes.back();
+        latency.m_stateMedian = median(stateTimes);
+        latency.m_stateMax = (stateTimes.empty()) ? 0. : stateTimes.back();
+        latencies.push_back(latency);
+    }
+    return latencies;
+}
+
+uint64_t CControlService::SImpl::timestamp()
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool CControlService::SImpl::activateNamedTopology(const SActivateParams& _params)
+{
+    // Composition is only committed if DDS accepts the combined topology
+    CTopologyComposer composer{ m_composer };
+    string topologyFile;
+    try
+    {
+        composer.set(_params.m_topologyName, _params.m_topologyFile);
+        if (composer.empty())
+        {
+            OLOG(ESeverity::error) << "Last named topology can't be removed, shut down the session instead";
+            return false;
+        }
+        topologyFile = composer.write();
+        m_composedFiles.insert(topologyFile);
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Failed to compose topology " << quoted(_params.m_topologyName) << ": "
+                               << _e.what();
+        return false;
+    }
+
+    // Topology without a name is replaced by the first named topology.
+    // Afterwards DDS only starts and stops the tasks of the changed topology.
+    const auto updateType{ (m_composer.empty()) ? STopologyRequest::request_t::EUpdateType::ACTIVATE
+                                                : STopologyRequest::request_t::EUpdateType::UPDATE };
+    if (updateType == STopologyRequest::request_t::EUpdateType::ACTIVATE)
+    {
+        m_excludedCollections.clear();
+    }
+
+    // DDS kills the tasks of the named topology which are replaced or removed, their devices are wound down first
+    bool success{ true };
+    if (updateType == STopologyRequest::request_t::EUpdateType::UPDATE && m_topo != nullptr)
+    {
+        string path;
+        try
+        {
+            const dds::topology_api::CTopology next(topologyFile);
+            path = taskDifferenceRegex(*m_topo, next, m_composer.pathRegex(_params.m_topologyName));
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Failed to compare topology " << quoted(_params.m_topologyName) << ": "
+                                   << _e.what();
+            success = false;
+        }
+        success = success && (path.empty() || endDevices(path));
+    }
+
+    OLOG(ESeverity::info) << "Activating topology " << quoted(_params.m_topologyName) << " as part of "
+                          << topologyFile;
+    success = success && activateDDSTopology(topologyFile, updateType) && createTopo(topologyFile) &&
+              createFairMQTopo(topologyFile);
+    if (success)
+    {
+        m_composer = composer;
+    }
+    // Combined topology is kept only if it became the current topology
+    removeComposedFiles(false);
+    return success;
+}
+
+bool CControlService::SImpl::resolvePath(const SDeviceParams& _params, string& _path) const
+{
+    if (!m_composer.contains(_params.m_topologyName))
+    {
+        OLOG(ESeverity::error) << "Topology " << quoted(_params.m_topologyName) << " is not active";
+        return false;
+    }
+    _path = m_composer.pathRegex(_params.m_topologyName, _params.m_path);
+    return true;
+}
+
+SAgentPlan CControlService::SImpl::agentPlan(const SSubmitParams& _params)
+{
+    const dds::topology_api::CTopology topo(_params.m_topologyFile);
+    SAgentPlan plan;
+
+    // Tasks of a collection are always placed on the same agent
+    vector<size_t> sizes;
+    auto collections = topo.getRuntimeCollectionIterator();
+    for (auto it = collections.first; it != collections.second; ++it)
+    {
+        sizes.push_back(it->second.m_collection->getNofTasks());
+    }
+    plan.m_numCollections = sizes.size();
+    auto tasks = topo.getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        plan.m_numTasks++;
+        if (it->second.m_taskCollectionId == 0)
+            sizes.push_back(1);
+    }
+    if (plan.m_numTasks == 0)
+        throw runtime_error("Topology has no tasks");
+
+    // All tasks of the localhost plugin run in a single agent
+    if (_params.m_rmsPlugin == "localhost")
+    {
+        plan.m_numAgents = 1;
+        plan.m_numSlots = plan.m_numTasks;
+        return plan;
+    }
+
+    sort(sizes.begin(), sizes.end(), greater<size_t>());
+    // Without a limit agents are as small as the largest collection
+    const size_t maxSlots{ (_params.m_numSlots > 0) ? _params.m_numSlots : sizes.front() };
+    if (sizes.front() > maxSlots)
+        throw runtime_error("Collection with " + to_string(sizes.front()) + " tasks doesn't fit into an agent with " +
+                            to_string(maxSlots) + " slots");
+
+    // First fit decreasing
+    vector<size_t> freeSlots;
+    for (auto size : sizes)
+    {
+        auto it = find_if(freeSlots.begin(), freeSlots.end(), [size](size_t _free) { return _free >= size; });
+        if (it == freeSlots.end())
+            freeSlots.push_back(maxSlots - size);
+        else
+            *it -= size;
+    }
+    plan.m_numAgents = freeSlots.size();
+    // Slots which are free on every agent are not requested
+    plan.m_numSlots = maxSlots - *min_element(freeSlots.begin(), freeSlots.end());
+    return plan;
+}
+
+bool CControlService::SImpl::excludeStragglers(fair::mq::sdk::TopologyTransition _transition,
+                                               const string& _path,
+                                               const SStragglerParams& _stragglers)
+{
+    const auto expected = fair::mq::sdk::expectedState.find(_transition);
+    if (expected == fair::mq::sdk::expectedState.end() || m_topo == nullptr || m_fairmqTopology == nullptr)
+        return false;
+
+    try
+    {
+        const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+        size_t numDevices{ 0 };
+        set<uint64_t> collectionIDs;
+        stringstream stragglers;
+        size_t numStragglers{ 0 };
+        const auto currentState{ m_fairmqTopology->GetCurrentState() };
+        for (const auto& status : currentState)
+        {
+            if (!boost::regex_match(m_topo->getRuntimeTaskById(status.taskId).m_taskPath, pathRegex))
+                continue;
+
+            numDevices++;
+            if (status.state == expected->second)
+                continue;
+
+            if (status.collectionId == 0)
+            {
+                OLOG(ESeverity::error) << "Straggler task " << status.taskId
+                                       << " is not in a collection, it can't be isolated";
+                return false;
+            }
+            collectionIDs.insert(status.collectionId);
+            stragglers << " " << status.taskId << " (" << status.state << ")";
+            numStragglers++;
+        }
+
+        // Failure is not caused by the devices, e.g. the reply was lost
+        if (numStragglers == 0)
+            return numDevices > 0;
+
+        if (static_cast<double>(numStragglers) > _stragglers.m_maxFraction * numDevices)
+        {
+            OLOG(ESeverity::error) << numStragglers << " of " << numDevices << " devices missed the soft deadline of "
+                                   << _transition << ", at most " << (_stragglers.m_maxFraction * 100)
+                                   << "% can be excluded. Stragglers:" << stragglers.str();
+            return false;
+        }
+
+        m_excludedCollections.insert(collectionIDs.begin(), collectionIDs.end());
+        OLOG(ESeverity::warning) << "Excluding " << collectionIDs.size() << " collections with " << numStragglers
+                                 << " devices which missed the soft deadline of " << _transition
+                                 << ". Stragglers:" << stragglers.str();
+
+        if (_stragglers.m_policy == EStragglerPolicy::terminate)
+        {
+            terminateCollections(collectionIDs, _stragglers.m_softDeadline);
+        }
+        return true;
+    }
+    catch (exception& _e)
+    {
+        OLOG(ESeverity::error) << "Failed to exclude stragglers: " << _e.what();
+    }
+    return false;
+}
+
+void CControlService::SImpl::terminateCollections(const set<uint64_t>& _collectionIDs, const chrono::seconds& _timeout)
+{
+    stringstream ss;
+    ss << "(";
+    for (auto it = _collectionIDs.begin(); it != _collectionIDs.end(); ++it)
+    {
+        ss << ((it == _collectionIDs.begin()) ? "" : "|")
+           << escapeRegex(m_topo->getRuntimeCollectionById(*it).m_collectionPath);
+    }
+    ss << ")/.*";
+
+    // Best effort: each device accepts only the transition which is valid in its current state
+    const SStragglerParams params(EStragglerPolicy::fail, _timeout);
+    for (auto transition : { fair::mq::sdk::TopologyTransition::Stop,
+                             fair::mq::sdk::TopologyTransition::ResetTask,
+                             fair::mq::sdk::TopologyTransition::ResetDevice,
+                             fair::mq::sdk::TopologyTransition::End })
+    {
+        changeState(transition, ss.str(), nullptr, params);
+    }
+}
+
+string CControlService::SImpl::excludedPath(const string& _path) const
+{
+    const string path{ devicePath(_path) };
+    const auto collections{ excludedCollectionPaths() };
+    if (collections.empty())
+        return path;
+
+    // Negative lookahead rejects tasks of excluded collections, the rest has to match the requested path
+    stringstream ss;
+    ss << "(?!(";
+    for (auto it = collections.begin(); it != collections.end(); ++it)
+    {
+        ss << ((it == collections.begin()) ? "" : "|") << escapeRegex(*it);
+    }
+    ss << ")/)(" << ((path.empty()) ? ".*" : path) << ")";
+    return ss.str();
+}
+
+string CControlService::SImpl::devicePath(const string& _path) const
+{
+    if (m_helperPath.empty())
+        return _path;
+    return m_helperPath + "(" + ((_path.empty()) ? ".*" : _path) + ")";
+}
+
+void CControlService::SImpl::updateHelperTasks()
+{
+    m_helperTasks.clear();
+    m_helperPath.clear();
+    set<string> names;
+    auto tasks = m_topo->getRuntimeTaskIterator(
+        [](const STopoRuntimeTask::Map_t::value_type& _value) { return isHelperTask(_value.second); });
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        m_helperTasks.insert(it->first);
+        names.insert(it->second.m_task->getName());
+    }
+    if (names.empty())
+        return;
+
+    // Helper tasks don't run a FairMQ state machine. Negative lookahead rejects their paths, which end with the
+    // task name and an optional index, so that requests don't wait for them.
+    stringstream ss;
+    ss << "(?!(.*/)?(";
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        ss << ((it == names.begin()) ? "" : "|") << escapeRegex(*it);
+    }
+    ss << ")(_[0-9]+)?$)";
+    m_helperPath = ss.str();
+    OLOG(ESeverity::info) << "Topology contains " << m_helperTasks.size()
+                          << " helper tasks, they are excluded from device requests";
+}
+
+bool CControlService::SImpl::isHelperTask(const STopoRuntimeTask& _task)
+{
+    const string exe{ _task.m_task->getExe() };
+    return exe.compare(0, kShmMonitorExe.size(), kShmMonitorExe) == 0 ||
+           exe.find("/" + kShmMonitorExe) != string::npos;
+}
+
+set<string> CControlService::SImpl::excludedCollectionPaths() const
+{
+    set<string> paths;
+    if (m_topo == nullptr)
+        return paths;
+
+    for (auto id : m_excludedCollections)
+    {
+        try
+        {
+            paths.insert(m_topo->getRuntimeCollectionById(id).m_collectionPath);
+        }
+        catch (exception& _e)
+        {
+            // Collection was removed by an update
+        }
+    }
+    return paths;
+}
+
+bool CControlService::SImpl::setProperty(const SSetPropertyParams& _params)
+{
+    return setProperties({ _params });
+}
+
+bool CControlService::SImpl::setProperties(const vector<SSetPropertyParams>& _params)
+{
+    if (m_fairmqTopology == nullptr)
+        return false;
+
+    bool success(true);
+    // Requests share the timeout
+    const auto deadline{ chrono::steady_clock::now() + m_timeout };
+    size_t begin{ 0 };
+    while (begin < _params.size())
+    {
+        // Requests of a batch are sent before waiting, so that devices apply them concurrently.
+        // A key set by an earlier request of the batch starts a new batch: selectors may overlap and the values
+        // have to be applied in the given order.
+        set<string> keys;
+        size_t end{ begin };
+        for (; end < _params.size(); ++end)
+        {
+            const auto& properties{ _params[end].m_properties };
+            const bool overlap{ any_of(properties.begin(), properties.end(), [&keys](const pair<string, string>& _p) {
+                return keys.count(_p.first) > 0;
+            }) };
+            if (overlap)
+                break;
+            for (const auto& property : properties)
+            {
+                keys.insert(property.first);
+            }
+        }
+
+        vector<CRequestWait::ptr_t> waits;
+        try
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto wait = make_shared<CRequestWait>();
+                m_fairmqTopology->AsyncSetProperties(_params[i].m_properties,
+                                                     devicePath(_params[i].m_path),
+                                                     m_timeout,
+                                                     [wait, this](std::error_code _ec, fair::mq::sdk::FailedDevices) {
+                                                         m_executor.post([_ec]() {
+                                                             OLOG(ESeverity::info)
+                                                                 << "Set property result: " << _ec.message();
+                                                         });
+                                                         if (_ec)
+                                                             wait->error(_ec.message());
+                                                         else
+                                                             wait->done();
+                                                     });
+                waits.push_back(wait);
+            }
+        }
+        catch (exception& _e)
+        {
+            success = false;
+            OLOG(ESeverity::error) << "Set property failed: " << _e.what();
+        }
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            bool applied(false);
+            if (i - begin < waits.size())
+            {
+                const auto remaining{ chrono::duration_cast<chrono::milliseconds>(deadline -
+                                                                                  chrono::steady_clock::now()) };
+                applied = waitForRequest(waits[i - begin], max(remaining, chrono::milliseconds(0)), "set property");
+            }
+            cacheProperties(_params[i], applied);
+            success = success && applied;
+        }
+        begin = end;
+    }
+    return success;
+}
+
+SDeviceProperties::properties_t CControlService::SImpl::changedProperties(const SSetPropertyParams& _params) const
+{
+    if (_params.m_force)
+        return _params.m_properties;
+
+    SDeviceProperties::properties_t changed;
+    auto cached = m_propertyCache.find(_params.m_path);
+    for (const auto& property : _params.m_properties)
+    {
+        if (cached != m_propertyCache.end())
+        {
+            auto it = cached->second.find(property.first);
+            if (it != cached->second.end() && it->second == property.second)
+                continue;
+        }
+        changed.push_back(property);
+    }
+    return changed;
+}
+
+void CControlService::SImpl::cacheProperties(const SSetPropertyParams& _params, bool _applied)
+{
+    for (const auto& property : _params.m_properties)
+    {
+        // Selectors may overlap: value cached for another selector is not known to be current anymore
+        for (auto& cached : m_propertyCache)
+        {
+            cached.second.erase(property.first);
+        }
+        // Some devices might have the new value after a failure, next request sends it again
+        if (_applied)
+        {
+            m_propertyCache[_params.m_path][property.first] = property.second;
+        }
     }
-    return m_fairmqTopology != nullptr;
 }
 
-bool CControlService::SImpl::changeState(fair::mq::sdk::TopologyTransition _transition,
-                                         const string& _path,
-                                         TopologyState* _topologyState)
+bool CControlService::SImpl::getProperties(const SGetPropertiesParams& _params,
+                                           SReturnDetails& _details,
+                                           CRequestWait::ptr_t _wait)
 {
     if (m_fairmqTopology == nullptr)
         return false;
 
+    // Build a regex matching exactly the requested keys
+    string query;
+    if (_params.m_keys.empty())
+    {
+        query = ".*";
+    }
+    else
+    {
+        for (const auto& key : _params.m_keys)
+        {
+            query += (query.empty() ? "^(" : "|") + escapeRegex(key);
+        }
+        query += ")$";
+    }
+
     bool success(true);
 
     try
     {
-        fair::mq::sdk::DeviceState targetState;
-        std::condition_variable cv;
-
-        m_fairmqTopology->AsyncChangeState(_transition,
-                                           _path,
-                                           m_timeout,
-                                           [&cv, &success, &targetState, &_topologyState, this](
-                                               std::error_code _ec, fair::mq::sdk::TopologyState _state) {
-                                               OLOG(ESeverity::info) << "Change transition result: " << _ec.message();
-                                               success = !_ec;
-                                               try
-                                               {
-                                                   targetState = fair::mq::sdk::AggregateState(_state);
-                                               }
-                                               catch (exception& _e)
-                                               {
-                                                   success = false;
-                                                   OLOG(ESeverity::error) << "Change state failed: " << _e.what();
-                                               }
-                                               if (_topologyState != nullptr)
-                                                   fairMQToODCTopologyState(_state, _topologyState);
-                                               cv.notify_all();
-                                           });
-
-        std::mutex mtx;
-        std::unique_lock<std::mutex> lock(mtx);
-        std::cv_status waitStatus = cv.wait_for(lock, m_timeout);
-
-        if (waitStatus == std::cv_status::timeout)
+        // Partial results of failed requests are reported as well, so errors don't abort the wait
+        auto wait = (_wait != nullptr) ? _wait : make_shared<CRequestWait>(0);
+        auto resultPtr = make_shared<fair::mq::sdk::GetPropertiesResult>();
+
+        m_fairmqTopology->AsyncGetProperties(
+            query,
+            devicePath(_params.m_path),
+            m_timeout,
+            [wait, resultPtr, this](std::error_code _ec, fair::mq::sdk::GetPropertiesResult _result) {
+                *resultPtr = std::move(_result);
+                m_executor.post([_ec]() { OLOG(ESeverity::info) << "Get properties result: " << _ec.message(); });
+                if (_ec)
+                    wait->error(_ec.message());
+                wait->done();
+            });
+
+        success = wait->wait(m_timeout);
+        if (wait->timedOut())
         {
-            success = false;
-            OLOG(ESeverity::error) << "Timed out waiting for change state " << _transition;
+            OLOG(ESeverity::error) << "Timed out waiting for get properties";
+            return false;
+        }
+        if (wait->aborted())
+        {
+            OLOG(ESeverity::info) << "Get properties aborted: " << wait->errorMessage();
+            return false;
+        }
+        const fair::mq::sdk::GetPropertiesResult& result{ *resultPtr };
+
+        OLOG(ESeverity::info) << "Get properties done: " << result.devices.size() << " devices replied, "
+                              << result.failed.size() << " failed";
+
+        _details.m_failedDevices.insert(result.failed.begin(), result.failed.end());
+        if (_params.m_aggregate)
+        {
+            aggregateProperties(result, _details.m_propertyAggregates);
         }
         else
         {
-            OLOG(ESeverity::info) << "Change state done successfully " << _transition;
+            _details.m_deviceProperties.reserve(result.devices.size());
+            for (const auto& device : result.devices)
+            {
+                _details.m_deviceProperties.push_back(
+                    SDeviceProperties(device.first, deviceIDToPath(device.first), device.second.props));
+            }
         }
     }
     catch (exception& _e)
     {
         success = false;
-        OLOG(ESeverity::error) << "Change state failed: " << _e.what();
+        OLOG(ESeverity::error) << "Get properties failed: " << _e.what();
     }
 
     return success;
 }
 
-bool CControlService::SImpl::changeStateConfigure(const string& _path, TopologyState* _topologyState)
+void CControlService::SImpl::aggregateProperties(const fair::mq::sdk::GetPropertiesResult& _result,
+                                                 SPropertyAggregate::container_t& _aggregates) const
 {
-    return changeState(fair::mq::sdk::TopologyTransition::InitDevice, _path, _topologyState) &&
-           changeState(fair::mq::sdk::TopologyTransition::CompleteInit, _path, _topologyState) &&
-           changeState(fair::mq::sdk::TopologyTransition::Bind, _path, _topologyState) &&
-           changeState(fair::mq::sdk::TopologyTransition::Connect, _path, _topologyState) &&
-           changeState(fair::mq::sdk::TopologyTransition::InitTask, _path, _topologyState);
+    // Distinct values are counted in full, but only a limited number of them is returned
+    map<string, map<string, size_t>> values;
+    map<string, SPropertyAggregate> aggregates;
+    for (const auto& device : _result.devices)
+    {
+        for (const auto& property : device.second.props)
+        {
+            SPropertyAggregate& aggregate = aggregates[property.first];
+            aggregate.m_key = property.first;
+            values[property.first][property.second]++;
+
+            double number{ 0 };
+            bool numeric{ aggregate.m_numeric };
+            if (numeric)
+            {
+                try
+                {
+                    size_t pos{ 0 };
+                    number = stod(property.second, &pos);
+                    numeric = (pos == property.second.size());
+                }
+                catch (exception&)
+                {
+                    numeric = false;
+                }
+            }
+
+            if (numeric)
+            {
+                aggregate.m_min = (aggregate.m_numDevices == 0) ? number : min(aggregate.m_min, number);
+                aggregate.m_max = (aggregate.m_numDevices == 0) ? number : max(aggregate.m_max, number);
+            }
+            aggregate.m_numeric = numeric;
+            aggregate.m_numDevices++;
+        }
+    }
+
+    _aggregates.reserve(aggregates.size());
+    for (auto& v : aggregates)
+    {
+        SPropertyAggregate& aggregate = v.second;
+        const auto& distinct = values[v.first];
+        aggregate.m_numDistinct = distinct.size();
+        for (const auto& value : distinct)
+        {
+            if (aggregate.m_values.size() >= SPropertyAggregate::kMaxDistinctValues)
+                break;
+            aggregate.m_values.insert(value);
+        }
+        if (!aggregate.m_numeric)
+        {
+            aggregate.m_min = aggregate.m_max = 0;
+        }
+        _aggregates.push_back(move(aggregate));
+    }
 }
 
-bool CControlService::SImpl::changeStateReset(const string& _path, TopologyState* _topologyState)
+string CControlService::SImpl::deviceIDToPath(const string& _deviceID) const
 {
-    return changeState(fair::mq::sdk::TopologyTransition::ResetTask, _path, _topologyState) &&
-           changeState(fair::mq::sdk::TopologyTransition::ResetDevice, _path, _topologyState);
+    uint64_t taskID{ 0 };
+    if (m_topo == nullptr || !deviceIDToTaskID(_deviceID, taskID))
+        return string();
+    try
+    {
+        return m_topo->getRuntimeTaskById(taskID).m_taskPath;
+    }
+    catch (exception&)
+    {
+    }
+    return string();
 }
 
-bool CControlService::SImpl::setProperty(const SSetPropertyParams& _params)
+bool CControlService::SImpl::deviceIDToTaskID(const string& _deviceID, uint64_t& _taskID) const
 {
-    if (m_fairmqTopology == nullptr)
-        return false;
+    // Devices started by DDS use the DDS task ID as FairMQ device ID
+    try
+    {
+        size_t pos{ 0 };
+        _taskID = stoull(_deviceID, &pos);
+        return pos == _deviceID.size();
+    }
+    catch (exception&)
+    {
+    }
+    return false;
+}
 
-    bool success(true);
+string CControlService::SImpl::getTaskHost(uint64_t _taskID) const
+{
+    lock_guard<CTimedMutex> lock(m_taskInfoMutex);
+    auto it = m_taskInfo.find(_taskID);
+    return (it == m_taskInfo.end()) ? string() : it->second.m_host;
+}
 
-    try
+void CControlService::SImpl::subscribeShmMonitors()
+{
+    if (m_topo == nullptr)
+        return;
+
+    const vector<uint64_t> taskIDs(m_helperTasks.begin(), m_helperTasks.end());
+    m_shmMonitor.subscribe(taskIDs, m_shmMonitorInterval);
+}
+
+bool CControlService::SImpl::colocateChannels(const string& _path, SColocatedChannel::container_t& _channels)
+{
+    if (m_topo == nullptr)
+        return false;
+
+    // Devices binding and connecting a channel: all devices with a global channel property or the devices of a
+    // collection instance with a collection scoped one.
+    // Key: property name, collection ID or 0 for global properties.
+    struct SEndpoints
     {
-        std::condition_variable cv;
+        vector<uint64_t> m_taskIDs;
+        bool m_write{ false };
+        bool m_read{ false };
+    };
+    using key_t = pair<string, uint64_t>;
+    map<key_t, SEndpoints> channels;
+    auto tasks = m_topo->getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        for (const auto& v : it->second.m_task->getProperties())
+        {
+            const auto& property{ v.second };
+            const string& name{ property->getName() };
+            if (name.compare(0, kChannelPropertyPrefix.size(), kChannelPropertyPrefix) != 0)
+                continue;
+
+            const bool collectionScope{ property->getScopeType() == EScopeType::COLLECTION };
+            SEndpoints& endpoints = channels[key_t(name, collectionScope ? it->second.m_taskCollectionId : 0)];
+            endpoints.m_taskIDs.push_back(it->first);
+            endpoints.m_write |= property->getAccessType() != EPropertyAccessType::READ;
+            endpoints.m_read |= property->getAccessType() != EPropertyAccessType::WRITE;
+        }
+    }
 
-        m_fairmqTopology->AsyncSetProperties({ { _params.m_key, _params.m_value } },
-                                             _params.m_path,
-                                             m_timeout,
-                                             [&cv, &success](std::error_code _ec, fair::mq::sdk::FailedDevices) {
-                                                 OLOG(ESeverity::info) << "Set property result: " << _ec.message();
-                                                 success = !_ec;
-                                                 cv.notify_all();
-                                             });
+    // Hosts are known from the activation, the transport is read by the devices in InitDevice
+    const boost::regex pathRegex{ (_path.empty()) ? ".*" : _path };
+    // Co-located channels with the paths of their devices
+    vector<pair<SColocatedChannel, vector<string>>> candidates;
+    for (const auto& v : channels)
+    {
+        const SEndpoints& endpoints{ v.second };
+        if (!endpoints.m_write || !endpoints.m_read)
+            continue;
+
+        string host;
+        vector<string> paths;
+        bool colocated{ true };
+        for (auto taskID : endpoints.m_taskIDs)
+        {
+            const string taskHost{ getTaskHost(taskID) };
+            const string& taskPath{ m_topo->getRuntimeTaskById(taskID).m_taskPath };
+            // Devices of other topologies are already configured and keep their transport
+            if (taskHost.empty() || (!host.empty() && taskHost != host) || !boost::regex_match(taskPath, pathRegex))
+            {
+                colocated = false;
+                break;
+            }
+            host = taskHost;
+            paths.push_back(taskPath);
+        }
+        if (!colocated)
+            continue;
+
+        SColocatedChannel channel;
+        channel.m_channel = v.first.first.substr(kChannelPropertyPrefix.size());
+        if (v.first.second != 0)
+            channel.m_collection = m_topo->getRuntimeCollectionById(v.first.second).m_collectionPath;
+        channel.m_host = host;
+        channel.m_numDevices = endpoints.m_taskIDs.size();
+        candidates.emplace_back(channel, paths);
+    }
+    if (candidates.empty())
+    {
+        OLOG(ESeverity::info) << "Shared memory transport selected for 0 of " << channels.size() << " channels";
+        return true;
+    }
 
-        std::mutex mtx;
-        std::unique_lock<std::mutex> lock(mtx);
-        std::cv_status waitStatus = cv.wait_for(lock, m_timeout);
+    // A channel can have several sub-channels, e.g. a connecting channel with one sub-channel per binding device.
+    // All of them need the same transport, so the number of sub-channels is read from the devices.
+    auto numSocketsKey = [](const string& _channel) { return "chans." + _channel + ".numSockets"; };
+    set<string> keys;
+    string allPaths;
+    for (const auto& candidate : candidates)
+    {
+        keys.insert(numSocketsKey(candidate.first.m_channel));
+        for (const auto& path : candidate.second)
+        {
+            allPaths += (allPaths.empty() ? "(" : "|") + escapeRegex(path);
+        }
+    }
+    SReturnDetails details;
+    if (!getProperties(SGetPropertiesParams(vector<string>(keys.begin(), keys.end()), allPaths + ")", false), details))
+        return false;
+    // Key: device path, property key
+    map<pair<string, string>, string> values;
+    for (const auto& device : details.m_deviceProperties)
+    {
+        for (const auto& property : device.m_properties)
+        {
+            values[make_pair(device.m_path, property.first)] = property.second;
+        }
+    }
 
-        if (waitStatus == std::cv_status::timeout)
+    vector<SSetPropertyParams> params;
+    for (const auto& candidate : candidates)
+    {
+        const string& name{ candidate.first.m_channel };
+        // Device path regex by number of sub-channels
+        map<size_t, string> regexes;
+        bool known{ true };
+        for (const auto& path : candidate.second)
         {
-            success = false;
-            OLOG(ESeverity::error) << "Timed out waiting for set property";
+            auto it = values.find(make_pair(path, numSocketsKey(name)));
+            size_t numSockets{ 0 };
+            try
+            {
+                numSockets = (it != values.end()) ? stoul(it->second) : 0;
+            }
+            catch (exception&)
+            {
+            }
+            if (numSockets == 0)
+            {
+                known = false;
+                break;
+            }
+            string& regex{ regexes[numSockets] };
+            regex += (regex.empty() ? "(" : "|") + escapeRegex(path);
         }
-        else
+        if (!known)
+        {
+            OLOG(ESeverity::warning) << "Number of sub-channels of channel " << name << " on " << candidate.first.m_host
+                                     << " is unknown, its transport is not changed";
+            continue;
+        }
+
+        for (const auto& v : regexes)
         {
-            OLOG(ESeverity::info) << "Set property done successfully";
+            SDeviceProperties::properties_t properties;
+            for (size_t i = 0; i < v.first; ++i)
+            {
+                properties.emplace_back("chans." + name + "." + to_string(i) + ".transport", "shmem");
+            }
+            params.emplace_back(properties, v.second + ")");
         }
+        _channels.push_back(candidate.first);
     }
-    catch (exception& _e)
+
+    OLOG(ESeverity::info) << "Shared memory transport selected for " << _channels.size() << " of " << channels.size()
+                          << " channels";
+    return params.empty() || setProperties(params);
+}
+
+bool CControlService::SImpl::fetchSamplerValues(const vector<string>& _keys,
+                                                vector<CThroughputSampler::SDeviceValue>& _values)
+{
+    // The wait is registered before the stop flag is checked, so stop() either sees and aborts it or the fetch
+    // returns here
+    auto wait = make_shared<CRequestWait>(0);
     {
-        success = false;
-        OLOG(ESeverity::error) << "Set property failed: " << _e.what();
+        lock_guard<mutex> lock(m_samplerWaitMutex);
+        m_samplerWait = wait;
     }
+    SReturnDetails details;
+    if (!m_sampler.stopping())
+        getProperties(SGetPropertiesParams(_keys, "", false), details, wait);
+    {
+        lock_guard<mutex> lock(m_samplerWaitMutex);
+        m_samplerWait = nullptr;
+    }
+
+    for (const auto& device : details.m_deviceProperties)
+    {
+        CThroughputSampler::SDeviceValue value;
+        value.m_deviceID = device.m_deviceID;
+        value.m_task = device.m_path;
+        uint64_t taskID{ 0 };
+        if (deviceIDToTaskID(device.m_deviceID, taskID))
+        {
+            value.m_host = getTaskHost(taskID);
+            const auto& task = m_topo->getRuntimeTaskById(taskID);
+            if (task.m_taskCollectionId != 0)
+                value.m_collection = m_topo->getRuntimeCollectionById(task.m_taskCollectionId).m_collectionPath;
+        }
+        for (const auto& property : device.m_properties)
+        {
+            value.m_key = property.first;
+            value.m_value = property.second;
+            _values.push_back(value);
+        }
+    }
+    return !details.m_deviceProperties.empty();
+}
+
+void CControlService::SImpl::cancelSamplerFetch()
+{
+    lock_guard<mutex> lock(m_samplerWaitMutex);
+    if (m_samplerWait != nullptr)
+        m_samplerWait->abort("Throughput sampler stopped");
+}
 
+bool CControlService::SImpl::waitForRequest(CRequestWait::ptr_t _wait,
+                                            const chrono::milliseconds& _timeout,
+                                            const string& _request)
+{
+    const bool success{ _wait->wait(_timeout) };
+    if (_wait->timedOut())
+    {
+        OLOG(ESeverity::error) << "Timed out waiting for " << _request;
+    }
+    else if (_wait->aborted())
+    {
+        OLOG(ESeverity::error) << "Aborted waiting for " << _request << ": " << _wait->errorMessage();
+    }
+    else if (!success)
+    {
+        OLOG(ESeverity::error) << "Failed " << _request << ": " << _wait->errorMessage();
+    }
+    else
+    {
+        OLOG(ESeverity::info) << "Done " << _request << " successfully";
+    }
     return success;
 }
 
+string CControlService::SImpl::escapeRegex(const string& _str)
+{
+    static const boost::regex specialChars{ R"([.^$|()\[\]{}*+?\\])" };
+    return boost::regex_replace(_str, specialChars, R"(\\$&)");
+}
+
 void CControlService::SImpl::fairMQToODCTopologyState(const fair::mq::sdk::TopologyState& _fairmq, TopologyState* _odc)
 {
     if (_odc == nullptr || m_topo == nullptr)
@@ -603,6 +2746,216 @@ void CControlService::SImpl::fairMQToODCTopologyState(const fair::mq::sdk::Topol
     }
 }
 
+void CControlService::SImpl::updateTopologyVersion(const string& _topologyFile)
+{
+    // FairMQ topology is created last in all requests which (re)create a topology
+    m_topologyVersion = nextTopologyVersion();
+    m_topologyFile = _topologyFile;
+    m_topologyHash = hashFile(_topologyFile);
+    // Properties of new devices are unknown
+    m_propertyCache.clear();
+    OLOG(ESeverity::info) << "Topology version " << m_topologyVersion << ", hash " << m_topologyHash;
+    // Combined topology might have been replaced
+    removeComposedFiles(false);
+}
+
+void CControlService::SImpl::removeComposedFiles(bool _all)
+{
+    // File of the current topology is read again, e.g. by GetTopology and rolling updates
+    for (auto it = m_composedFiles.begin(); it != m_composedFiles.end();)
+    {
+        if (!_all && *it == m_topologyFile)
+        {
+            ++it;
+            continue;
+        }
+        boost::system::error_code ec;
+        boost::filesystem::remove(*it, ec);
+        it = m_composedFiles.erase(it);
+    }
+}
+
+uint64_t CControlService::SImpl::nextTopologyVersion()
+{
+    // Clients cache device paths per version. A counter per partition starting at 1 would hand out the same
+    // version for different topologies in other partitions and after a restart of the server. The counter is
+    // shared by all partitions and starts from the time of the server start in us.
+    static atomic<uint64_t> version{ static_cast<uint64_t>(
+        chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count()) };
+    return ++version;
+}
+
+STopologyStructure CControlService::SImpl::topologyStructure() const
+{
+    namespace bpt = boost::property_tree;
+
+    STopologyStructure structure;
+    structure.m_topologyVersion = m_topologyVersion;
+    map<string, size_t> hosts;
+    map<string, size_t> properties;
+    auto intern = [](const string& _str, map<string, size_t>& _index, vector<string>& _table) {
+        const auto it = _index.emplace(_str, _table.size());
+        if (it.second)
+            _table.push_back(_str);
+        return it.first->second;
+    };
+    // Unknown host has index 0
+    intern(string(), hosts, structure.m_hosts);
+
+    // Multiplicities of the groups are only known from the topology file
+    bpt::ptree pt;
+    bpt::read_xml(m_topologyFile, pt, bpt::xml_parser::trim_whitespace);
+    for (const auto& v : pt.get_child("topology.main"))
+    {
+        if (v.first != "group")
+            continue;
+        STopologyStructure::SGroup group;
+        group.m_name = v.second.get<string>("<xmlattr>.name");
+        group.m_n = v.second.get<size_t>("<xmlattr>.n", 1);
+        structure.m_groups.push_back(group);
+    }
+
+    auto collections = m_topo->getRuntimeCollectionIterator();
+    for (auto it = collections.first; it != collections.second; ++it)
+    {
+        STopologyStructure::SCollection collection;
+        collection.m_id = it->first;
+        collection.m_path = structure.m_paths.size();
+        collection.m_numTasks = it->second.m_runtimeTasks.size();
+        structure.m_paths.push_back(it->second.m_collectionPath);
+        structure.m_collections.push_back(collection);
+    }
+
+    auto tasks = m_topo->getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        STopologyStructure::STask task;
+        task.m_id = it->first;
+        task.m_path = structure.m_paths.size();
+        task.m_collectionID = it->second.m_taskCollectionId;
+        task.m_host = intern(getTaskHost(it->first), hosts, structure.m_hosts);
+        structure.m_paths.push_back(it->second.m_taskPath);
+        for (const auto& v : it->second.m_task->getProperties())
+        {
+            const auto& property{ v.second };
+            if (property->getName().compare(0, kChannelPropertyPrefix.size(), kChannelPropertyPrefix) != 0)
+                continue;
+            STopologyStructure::SProperty channel;
+            channel.m_name = intern(property->getName(), properties, structure.m_properties);
+            channel.m_read = property->getAccessType() != EPropertyAccessType::WRITE;
+            channel.m_write = property->getAccessType() != EPropertyAccessType::READ;
+            task.m_properties.push_back(channel);
+        }
+        structure.m_tasks.push_back(move(task));
+    }
+    return structure;
+}
+
+void CControlService::SImpl::omitKnownPaths(uint64_t _knownVersion, SReturnDetails::ptr_t _details) const
+{
+    // Client has a cached path dictionary of the current topology
+    if (_details == nullptr || _knownVersion == 0 || _knownVersion != m_topologyVersion)
+        return;
+
+    for (auto& state : _details->m_topologyState)
+    {
+        state.m_path.clear();
+    }
+    for (auto& device : _details->m_deviceProperties)
+    {
+        device.m_path.clear();
+    }
+}
+
+string CControlService::SImpl::hashFile(const string& _filepath)
+{
+    // 64-bit FNV-1a of the file content
+    ifstream file(_filepath, ios::binary);
+    if (!file.is_open())
+        return string();
+
+    uint64_t hash{ 14695981039346656037ULL };
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+        for (streamsize i = 0; i < file.gcount(); ++i)
+        {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    stringstream ss;
+    ss << hex << setw(16) << setfill('0') << hash;
+    return ss.str();
+}
+
+void CControlService::SImpl::logDDSMessage(const SMessageResponseData& _message)
+{
+    if (_message.m_severity == dds::intercom_api::EMsgSeverity::error)
+    {
+        OLOG(ESeverity::error) << "Server reports error: " << _message.m_msg;
+    }
+    else
+    {
+        OLOG(ESeverity::debug) << "Server reports: " << _message.m_msg;
+    }
+}
+
+void CControlService::SImpl::updateTopologyMemoryStats()
+{
+    m_memoryStats->update("dds_topology", estimateDDSTopologyMemory());
+    m_memoryStats->update("fairmq_topology", estimateFairMQTopologyMemory());
+}
+
+size_t CControlService::SImpl::estimateDDSTopologyMemory() const
+{
+    if (m_topo == nullptr)
+        return 0;
+
+    // Each runtime task and collection is a node of a std::map. Collections hold a copy of their tasks.
+    const size_t nodeOverhead{ 4 * sizeof(void*) };
+    size_t bytes{ sizeof(dds::topology_api::CTopology) };
+
+    auto tasks = m_topo->getRuntimeTaskIterator();
+    for (auto it = tasks.first; it != tasks.second; ++it)
+    {
+        bytes += nodeOverhead + sizeof(*it) + it->second.m_taskPath.capacity();
+    }
+
+    auto collections = m_topo->getRuntimeCollectionIterator();
+    for (auto it = collections.first; it != collections.second; ++it)
+    {
+        bytes += nodeOverhead + sizeof(*it) + it->second.m_collectionPath.capacity();
+        for (const auto& task : it->second.m_runtimeTasks)
+        {
+            bytes += nodeOverhead + sizeof(task) + task.second.m_taskPath.capacity();
+        }
+    }
+    return bytes;
+}
+
+size_t CControlService::SImpl::estimateFairMQTopologyMemory() const
+{
+    if (m_fairmqTopology == nullptr)
+        return 0;
+
+    // FairMQ topology keeps a state vector and an index of task IDs. The DDS topology is reported as dds_topology.
+    const size_t numDevices{ m_fairmqTopology->GetCurrentState().size() };
+    const size_t indexEntry{ sizeof(std::pair<uint64_t, size_t>) + 2 * sizeof(void*) };
+    return sizeof(fair::mq::sdk::Topology) + numDevices * (sizeof(fair::mq::sdk::DeviceStatus) + indexEntry);
+}
+
+size_t CControlService::SImpl::estimateTopologyStateMemory(const TopologyState& _state)
+{
+    size_t bytes{ _state.capacity() * sizeof(SDeviceStatus) };
+    for (const auto& status : _state)
+    {
+        bytes += status.m_path.capacity();
+    }
+    return bytes;
+}
+
 //
 // CControlService
 //
@@ -617,57 +2970,144 @@ void CControlService::setTimeout(const chrono::seconds& _timeout)
     m_impl->setTimeout(_timeout);
 }
 
+void CControlService::setSamplerParams(const SSamplerParams& _params)
+{
+    m_impl->setSamplerParams(_params);
+}
+
+void CControlService::setEventLogDir(const std::string& _dir)
+{
+    m_impl->setEventLogDir(_dir);
+}
+
+void CControlService::setConfigDir(const std::string& _dir)
+{
+    m_impl->setConfigDir(_dir);
+}
+
+void CControlService::setAgentCheckInterval(const std::chrono::milliseconds& _interval)
+{
+    m_impl->setAgentCheckInterval(_interval);
+}
+
+void CControlService::setShmMonitorInterval(const std::chrono::milliseconds& _interval)
+{
+    m_impl->setShmMonitorInterval(_interval);
+}
+
+void CControlService::setExchangeTiming(bool _enabled)
+{
+    m_impl->setExchangeTiming(_enabled);
+}
+
+bool CControlService::waitForThroughputSample(uint64_t _lastSequence,
+                                              const chrono::milliseconds& _timeout,
+                                              SThroughputSample& _sample)
+{
+    return m_impl->waitForThroughputSample(_lastSequence, _timeout, _sample);
+}
+
 SReturnValue CControlService::execInitialize(const SInitializeParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Initialize");
     return m_impl->execInitialize(_params);
 }
 
 SReturnValue CControlService::execSubmit(const SSubmitParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Submit");
     return m_impl->execSubmit(_params);
 }
 
 SReturnValue CControlService::execActivate(const SActivateParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Activate");
     return m_impl->execActivate(_params);
 }
 
 SReturnValue CControlService::execUpdate(const SUpdateParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Update");
     return m_impl->execUpdate(_params);
 }
 
 SReturnValue CControlService::execShutdown()
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Shutdown");
     return m_impl->execShutdown();
 }
 
 SReturnValue CControlService::execSetProperty(const SSetPropertyParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "SetProperty");
     return m_impl->execSetProperty(_params);
 }
 
+SReturnValue CControlService::execGetProperties(const SGetPropertiesParams& _params)
+{
+    CInFlightOperations::CScope operation(m_impl->operations(), "GetProperties");
+    return m_impl->execGetProperties(_params);
+}
+
+SReturnValue CControlService::execSaveConfig(const SSaveConfigParams& _params)
+{
+    CInFlightOperations::CScope operation(m_impl->operations(), "SaveConfig");
+    return m_impl->execSaveConfig(_params);
+}
+
+SReturnValue CControlService::execApplyConfig(const SApplyConfigParams& _params)
+{
+    CInFlightOperations::CScope operation(m_impl->operations(), "ApplyConfig");
+    return m_impl->execApplyConfig(_params);
+}
+
+SReturnValue CControlService::execGetTopology(const SGetTopologyParams& _params)
+{
+    CInFlightOperations::CScope operation(m_impl->operations(), "GetTopology");
+    return m_impl->execGetTopology(_params);
+}
+
+SReturnValue CControlService::execGetMetrics()
+{
+    return m_impl->execGetMetrics();
+}
+
+SReturnValue CControlService::execDiagnostics()
+{
+    return m_impl->execDiagnostics();
+}
+
+SServiceDiagnostics CControlService::diagnostics() const
+{
+    return m_impl->diagnostics();
+}
+
 SReturnValue CControlService::execConfigure(const SDeviceParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Configure");
     return m_impl->execConfigure(_params);
 }
 
 SReturnValue CControlService::execStart(const SDeviceParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Start");
     return m_impl->execStart(_params);
 }
 
 SReturnValue CControlService::execStop(const SDeviceParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Stop");
     return m_impl->execStop(_params);
 }
 
 SReturnValue CControlService::execReset(const SDeviceParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Reset");
     return m_impl->execReset(_params);
 }
 
 SReturnValue CControlService::execTerminate(const SDeviceParams& _params)
 {
+    CInFlightOperations::CScope operation(m_impl->operations(), "Terminate");
     return m_impl->execTerminate(_params);
 }
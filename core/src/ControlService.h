@@ -5,9 +5,19 @@
 #ifndef __ODC__ControlService__
 #define __ODC__ControlService__
 
+// ODC
+#include "DDSRequestStats.h"
+#include "Diagnostics.h"
+#include "MemoryStats.h"
+#include "ShmMonitor.h"
+#include "ThroughputSampler.h"
 // STD
+#include <chrono>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 // FairMQ
 #include <fairmq/sdk/Topology.h>
 
@@ -64,6 +74,179 @@ namespace odc
         /// \brief Aggregated topology state
         using TopologyState = SDeviceStatus::container_t;
 
+        /// \brief Holds properties of a single device
+        struct SDeviceProperties
+        {
+            using container_t = std::vector<SDeviceProperties>;
+            using properties_t = std::vector<std::pair<std::string, std::string>>;
+
+            SDeviceProperties()
+            {
+            }
+
+            SDeviceProperties(const std::string& _deviceID, const std::string& _path, const properties_t& _properties)
+                : m_deviceID(_deviceID)
+                , m_path(_path)
+                , m_properties(_properties)
+            {
+            }
+
+            std::string m_deviceID;    ///< FairMQ device ID
+            std::string m_path;        ///< Path in the topology, empty if device ID is not a known task ID
+            properties_t m_properties; ///< Key-value pairs
+        };
+
+        /// \brief Aggregated values of a single property over all devices
+        struct SPropertyAggregate
+        {
+            using container_t = std::vector<SPropertyAggregate>;
+
+            /// \brief Maximum number of distinct values stored in the aggregate
+            static constexpr size_t kMaxDistinctValues = 64;
+
+            std::string m_key;                      ///< Property key
+            std::map<std::string, size_t> m_values; ///< Distinct values with number of devices (limited)
+            size_t m_numDistinct{ 0 };              ///< Total number of distinct values
+            size_t m_numDevices{ 0 };               ///< Number of devices reporting the property
+            bool m_numeric{ true };                 ///< True if all values are numeric
+            double m_min{ 0 };                      ///< Minimum value, only if numeric
+            double m_max{ 0 };                      ///< Maximum value, only if numeric
+        };
+
+        /// \brief Progress and timing of a single wave of the rolling update
+        struct SUpdateWave
+        {
+            using container_t = std::vector<SUpdateWave>;
+
+            size_t m_index{ 0 };        ///< Index of the wave, starts from 1
+            size_t m_numAdded{ 0 };     ///< Number of started group instances of the target topology
+            size_t m_numRemoved{ 0 };   ///< Number of terminated group instances of the current topology
+            double m_capacity{ 0 };     ///< Running instances relative to the initial number after the wave
+            size_t m_activateTime{ 0 }; ///< Time of the activation of the new tasks in ms
+            size_t m_startTime{ 0 };    ///< Time of configuration and start of the new tasks in ms
+            size_t m_retireTime{ 0 };   ///< Time of the termination of the old tasks in ms
+            bool m_success{ false };    ///< True if the wave succeeded
+        };
+
+        /// \brief Device property holding the scheduled start time in ms since epoch. Set before Run.
+        const std::string kStartTimeProperty = "odc-start-time";
+
+        /// \brief Delay of the Running notifications relative to the scheduled start time.
+        /// \details Start of processing itself is not reported by devices. A device can't process before it is
+        /// Running, so the delay of its notification is a lower bound of its start skew.
+        struct SStartSkew
+        {
+            size_t m_numDevices{ 0 };   ///< Number of devices which reported Running
+            uint64_t m_targetTime{ 0 }; ///< Scheduled start time in ms since epoch, 0 if not scheduled
+            double m_median{ 0. };      ///< Median delay in ms, 0 if Running before the target time
+            double m_p90{ 0. };         ///< 90th percentile of the delay in ms
+            double m_p99{ 0. };         ///< 99th percentile of the delay in ms
+            double m_max{ 0. };         ///< Maximum delay in ms
+            size_t m_numLate{ 0 };      ///< Devices which reported Running after the scheduled start time
+        };
+
+        /// \brief Number of DDS agents and slots computed from a topology
+        struct SAgentPlan
+        {
+            size_t m_numAgents{ 0 };      ///< Number of DDS agents
+            size_t m_numSlots{ 0 };       ///< Number of slots per agent
+            size_t m_numTasks{ 0 };       ///< Number of tasks in the topology
+            size_t m_numCollections{ 0 }; ///< Number of collection instances in the topology
+        };
+
+        /// \brief Task launch latency aggregated over the tasks of a host or a DDS agent
+        struct SLaunchLatency
+        {
+            using container_t = std::vector<SLaunchLatency>;
+
+            std::string m_scope;         ///< "host" or "agent"
+            std::string m_name;          ///< Name of the host or DDS agent ID
+            size_t m_numTasks{ 0 };      ///< Number of tasks started by the activation
+            size_t m_numReported{ 0 };   ///< Tasks which sent their first state notification
+            double m_launchMedian{ 0. }; ///< Median time from the activation request to the task start in ms
+            double m_launchMax{ 0. };    ///< Maximum time from the activation request to the task start in ms
+            double m_stateMedian{ 0. };  ///< Median time from the activation request to the first device state in ms
+            double m_stateMax{ 0. };     ///< Maximum time from the activation request to the first device state in ms
+        };
+
+        /// \brief Prefix of the DDS properties holding the FairMQ channel addresses
+        const std::string kChannelPropertyPrefix = "fmqchan_";
+
+        /// \brief Latency of the exchange of a channel property between the devices binding and connecting a channel
+        /// \details The exchange of a value ends when its reader reaches DeviceReady. It starts when the last writer
+        /// reached Bound or, if later, when Connect was requested.
+        struct SPropertyLatency
+        {
+            using container_t = std::vector<SPropertyLatency>;
+
+            std::string m_property;     ///< DDS property name
+            std::string m_host;         ///< Host of the readers, empty for all hosts
+            size_t m_numWriters{ 0 };   ///< Devices writing the property
+            size_t m_numReaders{ 0 };   ///< Devices reading the property
+            double m_publishTime{ 0. }; ///< Time from the Bind request to the last writer reaching Bound in ms
+            double m_median{ 0. };      ///< Median exchange time in ms
+            double m_p90{ 0. };         ///< 90th percentile of the exchange time in ms
+            double m_max{ 0. };         ///< Maximum exchange time in ms
+        };
+
+        /// \brief Channel switched to the shared memory transport because all its devices run on the same host
+        struct SColocatedChannel
+        {
+            using container_t = std::vector<SColocatedChannel>;
+
+            std::string m_channel;    ///< FairMQ channel name
+            std::string m_collection; ///< Path of the collection instance, empty for a global channel
+            std::string m_host;       ///< Host of the devices
+            size_t m_numDevices{ 0 }; ///< Devices binding or connecting the channel
+        };
+
+        /// \brief Structural snapshot of the active topology
+        /// \details Paths, hosts and property names are stored once, elements refer to them by index. Clients cache
+        /// the snapshot per topology version and resolve the task IDs of state replies without paths.
+        struct STopologyStructure
+        {
+            /// \brief Group of the main element
+            struct SGroup
+            {
+                std::string m_name; ///< Name of the group
+                size_t m_n{ 1 };    ///< Multiplicity of the group
+            };
+
+            /// \brief Runtime collection
+            struct SCollection
+            {
+                uint64_t m_id{ 0 };     ///< DDS collection ID
+                size_t m_path{ 0 };     ///< Index of the path in m_paths
+                size_t m_numTasks{ 0 }; ///< Number of tasks of the collection
+            };
+
+            /// \brief Channel property declared by a task
+            struct SProperty
+            {
+                size_t m_name{ 0 };    ///< Index of the name in m_properties
+                bool m_read{ false };  ///< Task reads the property
+                bool m_write{ false }; ///< Task writes the property
+            };
+
+            /// \brief Runtime task
+            struct STask
+            {
+                uint64_t m_id{ 0 };                  ///< DDS task ID
+                size_t m_path{ 0 };                  ///< Index of the path in m_paths
+                uint64_t m_collectionID{ 0 };        ///< DDS collection ID, 0 if the task is not in a collection
+                size_t m_host{ 0 };                  ///< Index of the host in m_hosts
+                std::vector<SProperty> m_properties; ///< Channel properties of the task
+            };
+
+            uint64_t m_topologyVersion{ 0 };        ///< Topology version of the snapshot
+            std::vector<std::string> m_paths;       ///< Paths of collections and tasks
+            std::vector<std::string> m_hosts;       ///< Hosts of the tasks, the first entry is empty for unknown
+            std::vector<std::string> m_properties;  ///< Names of the channel properties
+            std::vector<SGroup> m_groups;           ///< Groups of the main element
+            std::vector<SCollection> m_collections; ///< Collections
+            std::vector<STask> m_tasks;             ///< Tasks
+        };
+
         struct SReturnDetails
         {
             using ptr_t = std::shared_ptr<SReturnDetails>;
@@ -77,7 +260,24 @@ namespace odc
             {
             }
 
-            TopologyState m_topologyState; ///< FairMQ aggregated topology state
+            TopologyState m_topologyState;                        ///< FairMQ aggregated topology state
+            SMemoryStat::container_t m_memoryStats;               ///< Memory usage per subsystem
+            SDeviceProperties::container_t m_deviceProperties;    ///< Properties per device
+            SPropertyAggregate::container_t m_propertyAggregates; ///< Aggregated properties
+            std::set<std::string> m_failedDevices;                ///< Devices which failed the request
+            SThroughputSample m_throughput;                       ///< Latest throughput sample
+            SShmSegmentStat::container_t m_shmStats;              ///< Shared memory usage per host and segment
+            SUpdateWave::container_t m_waves;                     ///< Waves of the rolling update
+            std::set<std::string> m_excludedCollections;          ///< Collections excluded as stragglers
+            SStartSkew m_startSkew;                               ///< Start skew of a scheduled start
+            SAgentPlan m_agentPlan;                               ///< Agents and slots computed by Submit
+            SLaunchLatency::container_t m_launchLatencies;        ///< Launch latency of the last activation
+            SPropertyLatency::container_t m_propertyLatencies;    ///< Channel property exchange of the last Configure
+            STopologyStructure m_topology;                        ///< Structure of the topology, only for GetTopology
+            SDDSRequestStat::container_t m_ddsRequests;           ///< Round trips of DDS requests per request type
+            SServiceDiagnostics m_diagnostics;                    ///< Diagnostics of the service, only for Diagnostics
+            SProcessDiagnostics m_process;                        ///< Diagnostics of the process, only for Diagnostics
+            SColocatedChannel::container_t m_colocatedChannels;   ///< Channels switched to shared memory by Activate
         };
 
         /// \brief Structure holds return value of the request
@@ -110,6 +310,8 @@ namespace odc
             SError m_error;          ///< In case of error containes information about the error
             runID_t m_runID{ 0 };    ///< Run ID
             std::string m_sessionID; ///< Session ID of DDS
+            uint64_t m_topologyVersion{ 0 }; ///< Unique per created topology in all partitions, 0 if none
+            std::string m_topologyHash;      ///< Hash of the topology file content
 
             // Optional parameters
             SReturnDetails::ptr_t m_details; ///< Details of the return value. Stored only if requested.
@@ -152,7 +354,9 @@ namespace odc
             std::string m_rmsPlugin;  ///< RMS plugin of DDS
             std::string m_configFile; ///< Path to the configuration file of the RMS plugin
             size_t m_numAgents{ 0 };  ///< Number of DDS agents
-            size_t m_numSlots{ 0 };   ///< Number of slots per DDS agent
+            size_t m_numSlots{ 0 };   ///< Number of slots per DDS agent. Upper limit if agents are sized by a topology.
+            /// If set, the number of agents and slots is computed from this topology
+            std::string m_topologyFile;
         };
 
         /// \brief Structure holds configuration parameters of the activate topology request
@@ -162,11 +366,21 @@ namespace odc
             {
             }
 
-            SActivateParams(const std::string& _topologyFile)
+            SActivateParams(const std::string& _topologyFile,
+                            const std::string& _topologyName = "",
+                            bool _colocate = false)
                 : m_topologyFile(_topologyFile)
+                , m_topologyName(_topologyName)
+                , m_colocate(_colocate)
             {
             }
             std::string m_topologyFile; ///< Path to the topoloy file
+            /// Name of a topology activated side by side with the other named topologies. If empty, the topology
+            /// replaces all active topologies. A named topology with an empty file is removed.
+            std::string m_topologyName;
+            /// Switch channels to the shared memory transport if all devices binding or connecting them run on the
+            /// same host. Set before Configure, devices apply the transport in InitDevice.
+            bool m_colocate{ false };
         };
 
         /// \brief Structure holds configuration parameters of the updatetopology request
@@ -176,11 +390,15 @@ namespace odc
             {
             }
 
-            SUpdateParams(const std::string& _topologyFile)
+            SUpdateParams(const std::string& _topologyFile, size_t _waveSize = 0, double _minCapacity = 1.0)
                 : m_topologyFile(_topologyFile)
+                , m_waveSize(_waveSize)
+                , m_minCapacity(_minCapacity)
             {
             }
             std::string m_topologyFile; ///< Path to the topoloy file
+            size_t m_waveSize{ 0 };     ///< Group instances replaced per wave of a rolling update. 0 means full update.
+            double m_minCapacity{ 1.0 }; ///< Minimum running instances relative to the initial number during rolling update
         };
 
         /// \brief Structure holds configuaration parameters of the SetProperty request
@@ -191,14 +409,166 @@ namespace odc
             }
 
             SSetPropertyParams(const std::string& _key, const std::string& _value, const std::string& _path)
-                : m_key(_key)
-                , m_value(_value)
+                : m_properties({ { _key, _value } })
+                , m_path(_path)
+            {
+            }
+
+            SSetPropertyParams(const SDeviceProperties::properties_t& _properties,
+                               const std::string& _path,
+                               bool _force = false)
+                : m_properties(_properties)
+                , m_path(_path)
+                , m_force(_force)
+            {
+            }
+            SDeviceProperties::properties_t m_properties; ///< Property keys and values
+            std::string m_path;                           ///< Path in the topology
+            bool m_force{ false };                        ///< Send unchanged properties too
+        };
+
+        /// \brief Structure holds configuration parameters of the SaveConfig request
+        struct SSaveConfigParams
+        {
+            SSaveConfigParams()
+            {
+            }
+
+            SSaveConfigParams(const std::string& _name, const std::vector<SSetPropertyParams>& _entries)
+                : m_name(_name)
+                , m_entries(_entries)
+            {
+            }
+            std::string m_name;                        ///< Name of the snapshot
+            std::vector<SSetPropertyParams> m_entries; ///< Property assignments. If empty, applied values are saved.
+        };
+
+        /// \brief Structure holds configuration parameters of the ApplyConfig request
+        struct SApplyConfigParams
+        {
+            SApplyConfigParams()
+            {
+            }
+
+            SApplyConfigParams(const std::string& _name, bool _force = false)
+                : m_name(_name)
+                , m_force(_force)
+            {
+            }
+            std::string m_name;    ///< Name of the snapshot
+            bool m_force{ false }; ///< Send unchanged properties too
+        };
+
+        /// \brief Structure holds configuaration parameters of the GetProperties request
+        struct SGetPropertiesParams
+        {
+            SGetPropertiesParams()
+            {
+            }
+
+            SGetPropertiesParams(const std::vector<std::string>& _keys,
+                                 const std::string& _path,
+                                 bool _aggregate,
+                                 uint64_t _topologyVersion = 0)
+                : m_keys(_keys)
                 , m_path(_path)
+                , m_aggregate(_aggregate)
+                , m_topologyVersion(_topologyVersion)
             {
             }
-            std::string m_key;   ///< Property key
-            std::string m_value; ///< Property value
-            std::string m_path;  ///< Path in the topology
+            std::vector<std::string> m_keys; ///< Property keys. If empty all properties are requested.
+            std::string m_path;              ///< Path in the topology
+            bool m_aggregate{ true };        ///< If True than return only aggregated values instead of per device values
+            uint64_t m_topologyVersion{ 0 }; ///< Topology version cached by the client. If current, paths are omitted.
+        };
+
+        /// \brief Client metadata key selecting the compression algorithm of the replies of a call
+        const std::string kCompressionMetadata = "odc-compression";
+
+        /// \brief Structure holds compression parameters of gRPC messages
+        struct SCompressionParams
+        {
+            SCompressionParams()
+            {
+            }
+
+            SCompressionParams(const std::string& _algorithm, size_t _threshold)
+                : m_algorithm(_algorithm)
+                , m_threshold(_threshold)
+            {
+            }
+
+            std::string m_algorithm{ "none" }; ///< Compression algorithm: none, gzip or deflate
+            size_t m_threshold{ 65536 };       ///< Messages smaller than this size in bytes are not compressed
+        };
+
+        /// \brief Structure holds configuration parameters of the GetTopology request
+        struct SGetTopologyParams
+        {
+            SGetTopologyParams()
+            {
+            }
+
+            SGetTopologyParams(uint64_t _topologyVersion)
+                : m_topologyVersion(_topologyVersion)
+            {
+            }
+            uint64_t m_topologyVersion{ 0 }; ///< Topology version cached by the client. If current, nothing is sent.
+        };
+
+        /// \brief Handling of devices which didn't complete a transition before the soft deadline
+        enum class EStragglerPolicy
+        {
+            fail,     ///< Request fails
+            isolate,  ///< Collections of stragglers are excluded from further transitions
+            terminate ///< Collections of stragglers are excluded and shut down
+        };
+
+        /// \brief Structure holds parameters of the degraded-mode continuation
+        struct SStragglerParams
+        {
+            SStragglerParams()
+            {
+            }
+
+            SStragglerParams(EStragglerPolicy _policy,
+                             const std::chrono::seconds& _softDeadline,
+                             double _maxFraction = 0.05)
+                : m_policy(_policy)
+                , m_softDeadline(_softDeadline)
+                , m_maxFraction(_maxFraction)
+            {
+            }
+
+            /// \brief True if the soft deadline is set
+            bool enabled() const
+            {
+                return m_softDeadline.count() > 0;
+            }
+
+            EStragglerPolicy m_policy{ EStragglerPolicy::fail }; ///< Handling of stragglers
+            std::chrono::seconds m_softDeadline{ 0 };            ///< Soft deadline of a transition, 0 to disable
+            double m_maxFraction{ 0.05 };                        ///< Maximum fraction of devices which can be excluded
+        };
+
+        /// \brief Structure holds parameters of the retry of devices which failed a transition
+        /// \brief Maximum number of retries of a failed transition
+        const size_t kMaxRetries = 10;
+
+        struct SRetryParams
+        {
+            SRetryParams()
+            {
+            }
+
+            SRetryParams(size_t _maxRetries, const std::chrono::milliseconds& _backoff)
+                : m_maxRetries(_maxRetries)
+                , m_backoff(_backoff)
+            {
+            }
+
+            size_t m_maxRetries{ 0 };                   ///< Number of retries of a failed transition, 0 to disable
+            std::chrono::milliseconds m_backoff{ 500 }; ///< Delay before the first retry, doubled up to the timeout
         };
 
         /// \brief Structure holds device state params used in FairMQ device state chenge requests.
@@ -208,13 +578,20 @@ namespace odc
             {
             }
 
-            SDeviceParams(const std::string& _path, bool _detailed)
+            SDeviceParams(const std::string& _path, bool _detailed, uint64_t _topologyVersion = 0)
                 : m_path(_path)
                 , m_detailed(_detailed)
+                , m_topologyVersion(_topologyVersion)
             {
             }
-            std::string m_path;       ///< Path to the topoloy file
-            bool m_detailed{ false }; ///< If True than return also detailed information
+            std::string m_path;              ///< Path to the topoloy file
+            bool m_detailed{ false };        ///< If True than return also detailed information
+            uint64_t m_topologyVersion{ 0 }; ///< Topology version cached by the client. If current, paths are omitted.
+            SStragglerParams m_stragglers;   ///< Degraded-mode continuation after the soft deadline
+            SRetryParams m_retry;            ///< Retry of devices which failed the transition
+            std::string m_topologyName;      ///< Named topology, the path is matched within its devices
+            /// Start time relative to the request, set as property before Run. 0 starts immediately.
+            std::chrono::milliseconds m_startDelay{ 0 };
         };
 
         class CControlService
@@ -227,6 +604,24 @@ namespace odc
             /// \param [in] _timeout Timeout in seconds
             void setTimeout(const std::chrono::seconds& _timeout);
 
+            /// \brief Set parameters of the throughput sampler which runs while devices are in Running state
+            void setSamplerParams(const SSamplerParams& _params);
+
+            /// \brief Set directory of the binary device event logs. Empty directory disables them.
+            void setEventLogDir(const std::string& _dir);
+
+            /// \brief Set directory of the configuration snapshots
+            void setConfigDir(const std::string& _dir);
+
+            /// \brief Set interval of the DDS agent health checks. Lost agents are replaced by new submissions.
+            /// \param [in] _interval Check interval. 0 disables the replacement.
+            void setAgentCheckInterval(const std::chrono::milliseconds& _interval);
+
+            /// \brief Set reporting interval of the shared memory monitor helper tasks
+            void setShmMonitorInterval(const std::chrono::milliseconds& _interval);
+            /// \brief Enable timing of the channel property exchange during Configure
+            void setExchangeTiming(bool _enabled);
+
             //
             // DDS topology and session requests
             //
@@ -238,12 +633,46 @@ namespace odc
             /// \brief Activate topology
             SReturnValue execActivate(const SActivateParams& _params);
             /// \brief Update topology. Can be called multiple times in order to update topology.
+            ///
+            /// If the wave size is set, groups of the current topology are replaced by groups of the new topology
+            /// in waves while the other devices keep running: new instances are activated, configured and started
+            /// before old instances are terminated.
             SReturnValue execUpdate(const SUpdateParams& _params);
             /// \brief Shutdown DDS session
             SReturnValue execShutdown();
 
             /// \brief Set property
             SReturnValue execSetProperty(const SSetPropertyParams& _params);
+            /// \brief Get properties
+            SReturnValue execGetProperties(const SGetPropertiesParams& _params);
+            /// \brief Store a named configuration snapshot on the server
+            SReturnValue execSaveConfig(const SSaveConfigParams& _params);
+            /// \brief Apply all property assignments of a configuration snapshot in one batch
+            SReturnValue execApplyConfig(const SApplyConfigParams& _params);
+            /// \brief Return the structure of the active topology, unless the client has the current version
+            SReturnValue execGetTopology(const SGetTopologyParams& _params);
+
+            //
+            // Metrics requests
+            //
+
+            /// \brief Return metrics of the service: memory usage per subsystem, latest throughput sample
+            SReturnValue execGetMetrics();
+            /// \brief Wait for a throughput sample newer than _lastSequence
+            /// \return False on timeout
+            bool waitForThroughputSample(uint64_t _lastSequence,
+                                         const std::chrono::milliseconds& _timeout,
+                                         SThroughputSample& _sample);
+
+            //
+            // Diagnostics requests
+            //
+
+            /// \brief Return diagnostics of the service and the process: CPU time and context switches per thread,
+            /// RSS, DDS session, requests in flight and lock contention. Cheap enough to be polled.
+            SReturnValue execDiagnostics();
+            /// \brief Diagnostics of the service only, without the process statistics
+            SServiceDiagnostics diagnostics() const;
 
             //
             // FairMQ device change state requests
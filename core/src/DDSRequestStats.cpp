@@ -0,0 +1,148 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "DDSRequestStats.h"
+#include "Logger.h"
+// STD
+#include <algorithm>
+
+using namespace odc::core;
+using namespace std;
+
+//
+// SDurationHistogram
+//
+const vector<double> SDurationHistogram::kBounds{ 1., 2., 5., 10., 20., 50., 100., 200., 500., 1000., 2000., 5000.,
+                                                  10000., 30000., 60000. };
+
+SDurationHistogram::SDurationHistogram()
+    : m_counts(kBounds.size() + 1, 0)
+{
+}
+
+void SDurationHistogram::add(double _duration)
+{
+    const size_t bucket = lower_bound(kBounds.begin(), kBounds.end(), _duration) - kBounds.begin();
+    m_counts[bucket]++;
+    m_count++;
+    m_sum += _duration;
+    m_max = max(m_max, _duration);
+}
+
+double SDurationHistogram::quantile(double _quantile) const
+{
+    if (m_count == 0)
+        return 0.;
+
+    // Upper bound of the bucket holding the quantile, the unbounded bucket is represented by the maximum
+    const double rank{ _quantile * m_count };
+    uint64_t count{ 0 };
+    for (size_t i = 0; i < kBounds.size(); ++i)
+    {
+        count += m_counts[i];
+        if (count >= rank)
+            return min(kBounds[i], m_max);
+    }
+    return m_max;
+}
+
+//
+// CDDSRequestStats::CTrace
+//
+CDDSRequestStats::CTrace::CTrace(const string& _request)
+    : m_request(_request)
+    , m_sendTime(chrono::steady_clock::now())
+{
+}
+
+void CDDSRequestStats::CTrace::message()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_finished)
+        return;
+    if (m_numMessages == 0)
+        m_firstMessage = chrono::steady_clock::now();
+    m_numMessages++;
+}
+
+void CDDSRequestStats::CTrace::done()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_finished || m_done)
+        return;
+    m_doneTime = chrono::steady_clock::now();
+    m_done = true;
+}
+
+//
+// CDDSRequestStats
+//
+CDDSRequestStats::CTrace::ptr_t CDDSRequestStats::start(const string& _request) const
+{
+    return make_shared<CTrace>(_request);
+}
+
+void CDDSRequestStats::finish(CTrace::ptr_t _trace, bool _success)
+{
+    using msec_t = chrono::duration<double, milli>;
+
+    double firstMessage{ 0. };
+    double done{ 0. };
+    uint64_t numMessages{ 0 };
+    bool hasDone{ false };
+    {
+        lock_guard<mutex> lock(_trace->m_mutex);
+        if (_trace->m_finished)
+            return;
+        // Synchronous calls are done when they return
+        if (!_trace->m_done && _success)
+        {
+            _trace->m_doneTime = chrono::steady_clock::now();
+            _trace->m_done = true;
+        }
+        _trace->m_finished = true;
+        numMessages = _trace->m_numMessages;
+        hasDone = _trace->m_done;
+        if (numMessages > 0)
+            firstMessage = msec_t(_trace->m_firstMessage - _trace->m_sendTime).count();
+        if (hasDone)
+            done = msec_t(_trace->m_doneTime - _trace->m_sendTime).count();
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        SDDSRequestStat& stat = m_stats[_trace->m_request];
+        stat.m_request = _trace->m_request;
+        stat.m_count++;
+        stat.m_numMessages += numMessages;
+        if (!_success)
+            stat.m_numFailed++;
+        if (numMessages > 0)
+            stat.m_firstMessage.add(firstMessage);
+        if (hasDone)
+            stat.m_done.add(done);
+    }
+
+    OLOG(ESeverity::debug) << "DDS request " << _trace->m_request << (_success ? " done" : " failed") << ": "
+                           << numMessages << " messages, first message after "
+                           << (numMessages > 0 ? to_string(firstMessage) + " ms" : string("-")) << ", done after "
+                           << (hasDone ? to_string(done) + " ms" : string("-"));
+}
+
+SDDSRequestStat::container_t CDDSRequestStats::get() const
+{
+    SDDSRequestStat::container_t result;
+    lock_guard<mutex> lock(m_mutex);
+    result.reserve(m_stats.size());
+    for (const auto& v : m_stats)
+        result.push_back(v.second);
+    return result;
+}
+
+void CDDSRequestStats::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_stats.clear();
+}
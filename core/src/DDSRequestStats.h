@@ -0,0 +1,107 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Round trip statistics of requests sent to the DDS commander.
+//
+
+#ifndef __ODC__DDSRequestStats__
+#define __ODC__DDSRequestStats__
+
+// STD
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Histogram of durations with fixed bucket bounds
+        struct SDurationHistogram
+        {
+            /// \brief Upper bounds of the buckets in ms. The last bucket above the last bound is unbounded.
+            static const std::vector<double> kBounds;
+
+            SDurationHistogram();
+
+            /// \brief Add a duration in ms
+            void add(double _duration);
+            /// \brief Estimate of the quantile from the bucket bounds
+            /// \param [in] _quantile Quantile between 0 and 1
+            double quantile(double _quantile) const;
+
+            std::vector<uint64_t> m_counts; ///< Count per bucket, one more than kBounds
+            uint64_t m_count{ 0 };          ///< Number of durations
+            double m_sum{ 0. };             ///< Sum of the durations in ms
+            double m_max{ 0. };             ///< Longest duration in ms
+        };
+
+        /// \brief Statistics of a single type of DDS request
+        struct SDDSRequestStat
+        {
+            using container_t = std::vector<SDDSRequestStat>;
+
+            std::string m_request;             ///< Type of the request
+            uint64_t m_count{ 0 };             ///< Number of requests
+            uint64_t m_numFailed{ 0 };         ///< Number of failed or timed out requests
+            uint64_t m_numMessages{ 0 };       ///< Number of messages and progress reports received
+            SDurationHistogram m_firstMessage; ///< Time from sending to the first message
+            SDurationHistogram m_done;         ///< Time from sending to done
+        };
+
+        /// \brief Thread safe registry of the round trips of DDS requests.
+        /// \details Each request is traced from sending to done. Asynchronous requests report their messages and
+        /// done from the callbacks, synchronous calls are done when they return. Callbacks hold a shared pointer of
+        /// the trace, late callbacks after a timeout are ignored.
+        class CDDSRequestStats
+        {
+          public:
+            /// \brief Round trip of a single request
+            class CTrace
+            {
+              public:
+                using ptr_t = std::shared_ptr<CTrace>;
+
+                CTrace(const std::string& _request);
+
+                /// \brief Message, progress or response received from the commander
+                void message();
+                /// \brief Done received from the commander
+                void done();
+
+              private:
+                friend class CDDSRequestStats;
+
+                std::mutex m_mutex;
+                std::string m_request;                                ///< Type of the request
+                std::chrono::steady_clock::time_point m_sendTime;     ///< Time of sending
+                std::chrono::steady_clock::time_point m_firstMessage; ///< Time of the first message
+                std::chrono::steady_clock::time_point m_doneTime;     ///< Time of done
+                uint64_t m_numMessages{ 0 };                          ///< Number of messages
+                bool m_done{ false };                                 ///< Done received
+                bool m_finished{ false };                             ///< Recorded in the statistics
+            };
+
+            /// \brief Start the trace of a request right before it is sent
+            CTrace::ptr_t start(const std::string& _request) const;
+            /// \brief Record the trace in the statistics after the wait for the request
+            /// \details Synchronous calls are done by this if done wasn't reported before.
+            /// \param [in] _success False if the request failed or timed out
+            void finish(CTrace::ptr_t _trace, bool _success);
+
+            /// \brief Snapshot of the statistics of all request types
+            SDDSRequestStat::container_t get() const;
+            /// \brief Drop all statistics
+            void clear();
+
+          private:
+            mutable std::mutex m_mutex;
+            std::map<std::string, SDDSRequestStat> m_stats; ///< Statistics per request type
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__DDSRequestStats__*/
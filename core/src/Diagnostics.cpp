@@ -0,0 +1,132 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "Diagnostics.h"
+#include "MemoryStats.h"
+// STD
+#include <fstream>
+#include <iterator>
+#include <sstream>
+// BOOST
+#include <boost/filesystem.hpp>
+// SYS
+#include <unistd.h>
+
+using namespace odc::core;
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+    /// \brief Read CPU times from /proc/self/task/<tid>/stat
+    bool readThreadTimes(const bfs::path& _dir, SThreadStat& _stat)
+    {
+        ifstream file((_dir / "stat").string());
+        string line;
+        if (!getline(file, line))
+            return false;
+
+        // Thread name may contain spaces and parentheses, fields are counted from the last parenthesis
+        const size_t nameEnd{ line.rfind(')') };
+        if (nameEnd == string::npos)
+            return false;
+        istringstream ss(line.substr(nameEnd + 1));
+        const vector<string> fields{ istream_iterator<string>(ss), istream_iterator<string>() };
+        // utime and stime are fields 14 and 15 of the stat line, i.e. 11 and 12 after the name
+        if (fields.size() < 13)
+            return false;
+        const uint64_t ticksPerSec{ static_cast<uint64_t>(sysconf(_SC_CLK_TCK)) };
+        _stat.m_userTime = stoull(fields[11]) * 1000 / ticksPerSec;
+        _stat.m_systemTime = stoull(fields[12]) * 1000 / ticksPerSec;
+        return true;
+    }
+
+    /// \brief Read the name and the context switches from /proc/self/task/<tid>/status
+    void readThreadStatus(const bfs::path& _dir, SThreadStat& _stat)
+    {
+        ifstream file((_dir / "status").string());
+        string line;
+        while (getline(file, line))
+        {
+            const size_t colon{ line.find(':') };
+            if (colon == string::npos)
+                continue;
+            const string key{ line.substr(0, colon) };
+            const size_t valueStart{ line.find_first_not_of(" \t", colon + 1) };
+            const string value{ valueStart == string::npos ? string() : line.substr(valueStart) };
+            if (key == "Name")
+                _stat.m_name = value;
+            else if (key == "voluntary_ctxt_switches")
+                _stat.m_voluntarySwitches = stoull(value);
+            else if (key == "nonvoluntary_ctxt_switches")
+                _stat.m_involuntarySwitches = stoull(value);
+        }
+    }
+} // namespace
+
+//
+// SProcessDiagnostics
+//
+SProcessDiagnostics SProcessDiagnostics::get()
+{
+    SProcessDiagnostics diagnostics;
+    diagnostics.m_rss = CMemoryStats::currentRSS();
+    diagnostics.m_peakRSS = CMemoryStats::peakRSS();
+
+    const bfs::path taskDir{ "/proc/self/task" };
+    boost::system::error_code ec;
+    for (bfs::directory_iterator it(taskDir, ec), end; !ec && it != end; it.increment(ec))
+    {
+        SThreadStat stat;
+        try
+        {
+            stat.m_tid = stoull(it->path().filename().string());
+            // Thread may exit while it is read
+            if (!readThreadTimes(it->path(), stat))
+                continue;
+            readThreadStatus(it->path(), stat);
+        }
+        catch (exception&)
+        {
+            continue;
+        }
+        diagnostics.m_threads.push_back(stat);
+    }
+    return diagnostics;
+}
+
+//
+// CInFlightOperations
+//
+uint64_t CInFlightOperations::start(const string& _name)
+{
+    lock_guard<mutex> lock(m_mutex);
+    const uint64_t id{ m_nextID++ };
+    m_operations.emplace(id, make_pair(_name, chrono::steady_clock::now()));
+    return id;
+}
+
+void CInFlightOperations::finish(uint64_t _id)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_operations.erase(_id);
+}
+
+SOperation::container_t CInFlightOperations::get() const
+{
+    const auto now{ chrono::steady_clock::now() };
+    SOperation::container_t result;
+    lock_guard<mutex> lock(m_mutex);
+    result.reserve(m_operations.size());
+    // IDs are increasing, the map is ordered by the start time
+    for (const auto& v : m_operations)
+    {
+        SOperation operation;
+        operation.m_name = v.second.first;
+        operation.m_age = chrono::duration_cast<chrono::milliseconds>(now - v.second.second).count();
+        result.push_back(operation);
+    }
+    return result;
+}
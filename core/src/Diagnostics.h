@@ -0,0 +1,185 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Self profiling of the control service: threads, in-flight operations and lock contention.
+//
+
+#ifndef __ODC__Diagnostics__
+#define __ODC__Diagnostics__
+
+// STD
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief CPU usage of a single thread of the process
+        struct SThreadStat
+        {
+            using container_t = std::vector<SThreadStat>;
+
+            uint64_t m_tid{ 0 };                 ///< Kernel thread ID
+            std::string m_name;                  ///< Thread name
+            uint64_t m_userTime{ 0 };            ///< CPU time in user mode in ms
+            uint64_t m_systemTime{ 0 };          ///< CPU time in kernel mode in ms
+            uint64_t m_voluntarySwitches{ 0 };   ///< Context switches while waiting, e.g. for a lock or I/O
+            uint64_t m_involuntarySwitches{ 0 }; ///< Context switches forced by the scheduler
+        };
+
+        /// \brief Request which is currently executed
+        struct SOperation
+        {
+            using container_t = std::vector<SOperation>;
+
+            std::string m_name;  ///< Name of the request
+            uint64_t m_age{ 0 }; ///< Time since the start in ms
+        };
+
+        /// \brief Contention of a single internal lock
+        struct SLockStat
+        {
+            using container_t = std::vector<SLockStat>;
+
+            std::string m_name;        ///< Name of the lock
+            uint64_t m_numLocks{ 0 };  ///< Number of acquisitions
+            uint64_t m_numWaits{ 0 };  ///< Number of acquisitions which had to wait
+            uint64_t m_waitTotal{ 0 }; ///< Total wait time in us
+            uint64_t m_waitMax{ 0 };   ///< Longest wait in us
+        };
+
+        /// \brief Diagnostics of a single control service
+        struct SServiceDiagnostics
+        {
+            std::string m_sessionID;              ///< DDS session ID, empty if no session
+            bool m_sessionRunning{ false };       ///< DDS session is running
+            SOperation::container_t m_operations; ///< Requests in flight
+            SLockStat::container_t m_locks;       ///< Contention of the internal locks
+        };
+
+        /// \brief Diagnostics of the server process
+        struct SProcessDiagnostics
+        {
+            /// \brief Read statistics of all threads of the process. Returns no threads if /proc is not available.
+            static SProcessDiagnostics get();
+
+            SThreadStat::container_t m_threads; ///< CPU usage per thread
+            size_t m_rss{ 0 };                  ///< Current resident set size in bytes
+            size_t m_peakRSS{ 0 };              ///< Peak resident set size in bytes
+        };
+
+        /// \brief Mutex which counts acquisitions and measures the time spent waiting for it.
+        /// \details Uncontended acquisitions only cost a try_lock and an atomic increment, the clock is only read if
+        /// the mutex is held by another thread. Satisfies the Lockable requirements.
+        class CTimedMutex
+        {
+          public:
+            CTimedMutex(const std::string& _name)
+                : m_name(_name)
+            {
+            }
+
+            void lock()
+            {
+                if (m_mutex.try_lock())
+                {
+                    m_numLocks.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                const auto start{ std::chrono::steady_clock::now() };
+                m_mutex.lock();
+                const auto duration{ std::chrono::steady_clock::now() - start };
+                const uint64_t wait = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+                m_numLocks.fetch_add(1, std::memory_order_relaxed);
+                m_numWaits.fetch_add(1, std::memory_order_relaxed);
+                m_waitTotal.fetch_add(wait, std::memory_order_relaxed);
+                // Mutex is held, the maximum has a single writer
+                if (wait > m_waitMax.load(std::memory_order_relaxed))
+                    m_waitMax.store(wait, std::memory_order_relaxed);
+            }
+
+            bool try_lock()
+            {
+                if (!m_mutex.try_lock())
+                    return false;
+                m_numLocks.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            void unlock()
+            {
+                m_mutex.unlock();
+            }
+
+            /// \brief Snapshot of the statistics, can be called while the mutex is held
+            SLockStat stat() const
+            {
+                SLockStat stat;
+                stat.m_name = m_name;
+                stat.m_numLocks = m_numLocks.load(std::memory_order_relaxed);
+                stat.m_numWaits = m_numWaits.load(std::memory_order_relaxed);
+                stat.m_waitTotal = m_waitTotal.load(std::memory_order_relaxed);
+                stat.m_waitMax = m_waitMax.load(std::memory_order_relaxed);
+                return stat;
+            }
+
+          private:
+            std::mutex m_mutex;
+            const std::string m_name;               ///< Name of the lock
+            std::atomic<uint64_t> m_numLocks{ 0 };  ///< Number of acquisitions
+            std::atomic<uint64_t> m_numWaits{ 0 };  ///< Number of acquisitions which had to wait
+            std::atomic<uint64_t> m_waitTotal{ 0 }; ///< Total wait time in us
+            std::atomic<uint64_t> m_waitMax{ 0 };   ///< Longest wait in us
+        };
+
+        /// \brief Thread safe registry of the requests which are currently executed
+        class CInFlightOperations
+        {
+          public:
+            /// \brief Registers an operation for the lifetime of the scope
+            class CScope
+            {
+              public:
+                CScope(CInFlightOperations& _operations, const std::string& _name)
+                    : m_operations(_operations)
+                    , m_id(_operations.start(_name))
+                {
+                }
+
+                ~CScope()
+                {
+                    m_operations.finish(m_id);
+                }
+
+                CScope(const CScope&) = delete;
+                CScope& operator=(const CScope&) = delete;
+
+              private:
+                CInFlightOperations& m_operations;
+                uint64_t m_id;
+            };
+
+            /// \brief Register the start of an operation
+            /// \return ID of the operation
+            uint64_t start(const std::string& _name);
+            /// \brief Remove an operation
+            void finish(uint64_t _id);
+            /// \brief Operations in flight, oldest first
+            SOperation::container_t get() const;
+
+          private:
+            using operation_t = std::pair<std::string, std::chrono::steady_clock::time_point>;
+
+            mutable std::mutex m_mutex;
+            uint64_t m_nextID{ 0 };                       ///< ID of the next operation
+            std::map<uint64_t, operation_t> m_operations; ///< Name and start time per operation ID
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__Diagnostics__*/
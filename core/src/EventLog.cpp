@@ -0,0 +1,166 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "EventLog.h"
+#include "Logger.h"
+// STD
+#include <chrono>
+#include <stdexcept>
+// BOOST
+#include <boost/filesystem.hpp>
+
+using namespace odc::core;
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+    void encodeUInt64(uint64_t _value, char* _buffer)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            _buffer[i] = static_cast<char>((_value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    uint64_t decodeUInt64(const char* _buffer)
+    {
+        uint64_t value{ 0 };
+        for (size_t i = 0; i < 8; ++i)
+        {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(_buffer[i])) << (8 * i);
+        }
+        return value;
+    }
+} // namespace
+
+//
+// SDeviceEvent
+//
+constexpr size_t SDeviceEvent::kSize;
+
+void SDeviceEvent::encode(char* _buffer) const
+{
+    encodeUInt64(m_timestamp, _buffer);
+    encodeUInt64(m_taskID, _buffer + 8);
+    encodeUInt64(m_runID, _buffer + 16);
+    _buffer[24] = static_cast<char>(m_type);
+    _buffer[25] = static_cast<char>(m_oldState);
+    _buffer[26] = static_cast<char>(m_newState);
+    _buffer[27] = static_cast<char>(m_reserved);
+}
+
+void SDeviceEvent::decode(const char* _buffer)
+{
+    m_timestamp = decodeUInt64(_buffer);
+    m_taskID = decodeUInt64(_buffer + 8);
+    m_runID = decodeUInt64(_buffer + 16);
+    m_type = static_cast<EEventType>(_buffer[24]);
+    m_oldState = static_cast<uint8_t>(_buffer[25]);
+    m_newState = static_cast<uint8_t>(_buffer[26]);
+    m_reserved = static_cast<uint8_t>(_buffer[27]);
+}
+
+//
+// CEventLog
+//
+const string CEventLog::kMagic{ "ODCEVT01" };
+
+void CEventLog::open(const string& _dir, const string& _sessionID)
+{
+    close();
+    if (_dir.empty())
+        return;
+
+    const bfs::path filepath{ bfs::path(_dir) / ("odc_events_" + _sessionID + ".bin") };
+    const bool exists{ bfs::exists(filepath) && bfs::file_size(filepath) > 0 };
+
+    lock_guard<CTimedMutex> lock(m_mutex);
+    m_file.open(filepath.string(), ios::binary | ios::app);
+    if (!m_file.is_open())
+    {
+        OLOG(ESeverity::error) << "Failed to open event log " << filepath.string();
+        return;
+    }
+    if (!exists)
+    {
+        m_file.write(kMagic.data(), kMagic.size());
+        m_file.flush();
+    }
+    OLOG(ESeverity::info) << "Device events are recorded in " << filepath.string();
+}
+
+void CEventLog::close()
+{
+    lock_guard<CTimedMutex> lock(m_mutex);
+    if (m_file.is_open())
+        m_file.close();
+}
+
+void CEventLog::transition(uint64_t _runID, fair::mq::sdk::TopologyTransition _transition)
+{
+    lock_guard<CTimedMutex> lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    SDeviceEvent event;
+    event.m_timestamp = now();
+    event.m_runID = _runID;
+    event.m_type = EEventType::transition;
+    event.m_newState = static_cast<uint8_t>(_transition);
+    write(event);
+    m_file.flush();
+}
+
+void CEventLog::stateChange(uint64_t _runID, const SStateChange& _change)
+{
+    lock_guard<CTimedMutex> lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    SDeviceEvent event;
+    event.m_timestamp = _change.m_timestamp;
+    event.m_taskID = _change.m_taskID;
+    event.m_runID = _runID;
+    event.m_type = EEventType::stateChange;
+    event.m_oldState = static_cast<uint8_t>(_change.m_lastState);
+    event.m_newState = static_cast<uint8_t>(_change.m_state);
+    write(event);
+    m_file.flush();
+}
+
+vector<SDeviceEvent> CEventLog::read(const string& _filepath)
+{
+    ifstream file(_filepath, ios::binary);
+    if (!file.is_open())
+        throw runtime_error("Can't open event log " + _filepath);
+
+    string magic(kMagic.size(), '\0');
+    if (!file.read(&magic[0], magic.size()) || magic != kMagic)
+        throw runtime_error(_filepath + " is not an ODC event log");
+
+    vector<SDeviceEvent> events;
+    char buffer[SDeviceEvent::kSize];
+    // Truncated last record of a crashed server is ignored
+    while (file.read(buffer, SDeviceEvent::kSize))
+    {
+        SDeviceEvent event;
+        event.decode(buffer);
+        events.push_back(event);
+    }
+    return events;
+}
+
+uint64_t CEventLog::now()
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void CEventLog::write(const SDeviceEvent& _event)
+{
+    char buffer[SDeviceEvent::kSize];
+    _event.encode(buffer);
+    m_file.write(buffer, SDeviceEvent::kSize);
+}
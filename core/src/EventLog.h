@@ -0,0 +1,93 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Append-only binary log of device state changes.
+//
+
+#ifndef __ODC__EventLog__
+#define __ODC__EventLog__
+
+// ODC
+#include "Diagnostics.h"
+#include "StateSubscription.h"
+// STD
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+// FairMQ
+#include <fairmq/sdk/Topology.h>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Type of an event record
+        enum class EEventType : uint8_t
+        {
+            stateChange = 0, ///< Device state changed
+            transition = 1   ///< Transition requested by ODC
+        };
+
+        /// \brief Single record of the event log
+        /// \details Records have a fixed size of kSize bytes, integers are stored little endian.
+        struct SDeviceEvent
+        {
+            static constexpr size_t kSize{ 28 }; ///< Size of an encoded record in bytes
+
+            /// \brief Encode the record into a buffer of kSize bytes
+            void encode(char* _buffer) const;
+            /// \brief Decode the record from a buffer of kSize bytes
+            void decode(const char* _buffer);
+
+            uint64_t m_timestamp{ 0 };                    ///< Microseconds since epoch
+            uint64_t m_taskID{ 0 };                       ///< DDS task ID, 0 for transition requests
+            uint64_t m_runID{ 0 };                        ///< Run ID
+            EEventType m_type{ EEventType::stateChange }; ///< Type of the record
+            uint8_t m_oldState{ 0 };                      ///< Previous fair::mq::State, unused for transitions
+            uint8_t m_newState{ 0 };                      ///< New fair::mq::State or requested fair::mq::Transition
+            uint8_t m_reserved{ 0 };                      ///< Padding
+        };
+
+        /// \brief Writes device state changes received by the state subscription to a file per DDS session.
+        /// \details Each state change is written with its arrival time and flushed, so the log survives a crash of
+        /// the server.
+        class CEventLog
+        {
+          public:
+            /// \brief Magic bytes at the beginning of each event log file
+            static const std::string kMagic;
+
+            /// \brief Open the event log of a session. Existing logs are appended.
+            /// \param [in] _dir Directory of the event logs. If empty, no events are recorded.
+            /// \param [in] _sessionID DDS session ID
+            void open(const std::string& _dir, const std::string& _sessionID);
+            /// \brief Close the event log
+            void close();
+
+            /// \brief Record the request of a transition
+            void transition(uint64_t _runID, fair::mq::sdk::TopologyTransition _transition);
+            /// \brief Record a state change of a device
+            void stateChange(uint64_t _runID, const SStateChange& _change);
+
+            /// \brief Read all records of an event log file
+            /// \throw std::runtime_error if the file can't be read or is not an event log
+            static std::vector<SDeviceEvent> read(const std::string& _filepath);
+
+            /// \brief Contention of the lock of the event log
+            SLockStat lockStat() const
+            {
+                return m_mutex.stat();
+            }
+
+          private:
+            static uint64_t now();
+            void write(const SDeviceEvent& _event);
+
+            CTimedMutex m_mutex{ "event_log" }; ///< Protects the file
+            std::ofstream m_file;               ///< Event log file
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__EventLog__*/
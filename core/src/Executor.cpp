@@ -0,0 +1,184 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "Executor.h"
+#include "Logger.h"
+
+using namespace odc::core;
+using namespace std;
+
+CExecutor::CExecutor(size_t _numThreads, size_t _queueCapacity)
+    : m_queueCapacity(max<size_t>(_queueCapacity, 1))
+{
+    size_t numThreads{ (_numThreads == 0) ? thread::hardware_concurrency() : _numThreads };
+    numThreads = max<size_t>(numThreads, 1);
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        m_queues.emplace_back(new SQueue());
+    }
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        m_threads.emplace_back(&CExecutor::worker, this, i);
+    }
+}
+
+CExecutor::~CExecutor()
+{
+    {
+        lock_guard<mutex> lock(m_waitMutex);
+        m_stop = true;
+    }
+    m_waitCondition.notify_all();
+    for (auto& t : m_threads)
+    {
+        if (t.joinable())
+            t.join();
+    }
+}
+
+void CExecutor::post(task_t _task)
+{
+    const size_t numQueues{ m_queues.size() };
+    const size_t start{ m_next++ };
+    for (size_t i = 0; i < numQueues; ++i)
+    {
+        if (tryPush((start + i) % numQueues, _task))
+        {
+            {
+                // Lock is required to avoid a lost wake up of a worker which is about to wait
+                lock_guard<mutex> lock(m_waitMutex);
+            }
+            m_waitCondition.notify_one();
+            return;
+        }
+    }
+
+    // All queues are full: execute on the calling thread
+    OLOG(ESeverity::debug) << "Executor queues are full, executing task on the calling thread";
+    _task();
+}
+
+shared_ptr<CExecutor> CExecutor::shared()
+{
+    static mutex instanceMutex;
+    static weak_ptr<CExecutor> instance;
+
+    lock_guard<mutex> lock(instanceMutex);
+    shared_ptr<CExecutor> executor{ instance.lock() };
+    if (executor == nullptr)
+    {
+        executor = make_shared<CExecutor>();
+        instance = executor;
+    }
+    return executor;
+}
+
+bool CExecutor::tryPush(size_t _index, task_t& _task)
+{
+    SQueue& queue{ *m_queues[_index] };
+    lock_guard<mutex> lock(queue.m_mutex);
+    if (queue.m_tasks.size() >= m_queueCapacity)
+        return false;
+    queue.m_tasks.push_back(move(_task));
+    ++m_pending;
+    return true;
+}
+
+bool CExecutor::tryPop(size_t _index, task_t& _task)
+{
+    const size_t numQueues{ m_queues.size() };
+    for (size_t i = 0; i < numQueues; ++i)
+    {
+        const bool own{ i == 0 };
+        SQueue& queue{ *m_queues[(_index + i) % numQueues] };
+        lock_guard<mutex> lock(queue.m_mutex);
+        if (queue.m_tasks.empty())
+            continue;
+
+        // Take from the front of the own queue, steal from the back of the others
+        if (own)
+        {
+            _task = move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+        }
+        else
+        {
+            _task = move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+        }
+        --m_pending;
+        return true;
+    }
+    return false;
+}
+
+void CExecutor::worker(size_t _index)
+{
+    while (true)
+    {
+        task_t task;
+        if (tryPop(_index, task))
+        {
+            try
+            {
+                task();
+            }
+            catch (exception& _e)
+            {
+                OLOG(ESeverity::error) << "Executor task failed: " << _e.what();
+            }
+            continue;
+        }
+
+        unique_lock<mutex> lock(m_waitMutex);
+        // Pending tasks are drained before the worker stops
+        if (m_stop && m_pending == 0)
+            return;
+        m_waitCondition.wait(lock, [this] { return m_stop || m_pending > 0; });
+    }
+}
+
+//
+// CTaskGroup
+//
+
+CTaskGroup::CTaskGroup(shared_ptr<CExecutor> _executor)
+    : m_executor(_executor)
+{
+}
+
+CTaskGroup::~CTaskGroup()
+{
+    wait();
+}
+
+void CTaskGroup::wait()
+{
+    unique_lock<mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_pending == 0; });
+}
+
+void CTaskGroup::post(task_t _task)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        ++m_pending;
+    }
+    m_executor->post([this, _task]() {
+        try
+        {
+            _task();
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Executor task failed: " << _e.what();
+        }
+        // Notify under the lock: the group might be destroyed as soon as the counter drops to 0
+        lock_guard<mutex> lock(m_mutex);
+        --m_pending;
+        m_condition.notify_all();
+    });
+}
@@ -0,0 +1,114 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Work stealing executor used to offload callbacks from DDS and FairMQ library threads.
+//
+
+#ifndef __ODC__Executor__
+#define __ODC__Executor__
+
+// STD
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Fixed size thread pool with one bounded queue per worker.
+        /// \details Tasks are distributed round robin over the queues. An idle worker takes tasks from the front of
+        /// its own queue and steals from the back of the other queues. If all queues are full the task is executed
+        /// by the caller, which provides back pressure instead of unbounded memory growth.
+        class CExecutor
+        {
+          public:
+            using task_t = std::function<void()>;
+
+            /// \brief Constructor
+            /// \param [in] _numThreads Number of worker threads. If 0 the number of hardware threads is used.
+            /// \param [in] _queueCapacity Maximum number of pending tasks per worker queue
+            CExecutor(size_t _numThreads = 0, size_t _queueCapacity = 1024);
+            /// \brief Destructor. Executes all pending tasks and joins the workers.
+            ~CExecutor();
+
+            /// \brief Schedule a task for execution
+            void post(task_t _task);
+
+            /// \brief Executor shared by all users in the process.
+            /// \details Created on first use with one thread per hardware thread, destroyed with its last user.
+            static std::shared_ptr<CExecutor> shared();
+
+            /// \brief Number of worker threads
+            size_t numThreads() const
+            {
+                return m_threads.size();
+            }
+
+            // Disable copy constructors and assignment operators
+            CExecutor(const CExecutor&) = delete;
+            CExecutor(CExecutor&&) = delete;
+            CExecutor& operator=(const CExecutor&) = delete;
+            CExecutor& operator=(CExecutor&&) = delete;
+
+          private:
+            struct SQueue
+            {
+                std::mutex m_mutex;
+                std::deque<task_t> m_tasks;
+            };
+
+            bool tryPush(size_t _index, task_t& _task);
+            bool tryPop(size_t _index, task_t& _task);
+            void worker(size_t _index);
+
+            std::vector<std::unique_ptr<SQueue>> m_queues; ///< One queue per worker
+            std::vector<std::thread> m_threads;           ///< Worker threads
+            size_t m_queueCapacity;                       ///< Maximum number of tasks per queue
+            std::atomic<size_t> m_next{ 0 };              ///< Round robin counter
+            std::atomic<size_t> m_pending{ 0 };           ///< Number of queued tasks
+            std::mutex m_waitMutex;                       ///< Protects idle waiting of the workers
+            std::condition_variable m_waitCondition;      ///< Wakes up idle workers
+            bool m_stop{ false };                         ///< Set on destruction
+        };
+
+        /// \brief Group of tasks executed by a shared executor.
+        /// \details Counts the tasks of one owner, so that the owner can be destroyed safely while the executor
+        /// keeps running tasks of other owners.
+        class CTaskGroup
+        {
+          public:
+            using task_t = CExecutor::task_t;
+
+            /// \brief Constructor
+            /// \param [in] _executor Executor running the tasks
+            CTaskGroup(std::shared_ptr<CExecutor> _executor = CExecutor::shared());
+            /// \brief Destructor. Waits until all tasks of the group are executed.
+            ~CTaskGroup();
+
+            /// \brief Schedule a task of the group for execution
+            void post(task_t _task);
+
+            /// \brief Wait until all tasks of the group scheduled so far are executed
+            void wait();
+
+            // Disable copy constructors and assignment operators
+            CTaskGroup(const CTaskGroup&) = delete;
+            CTaskGroup(CTaskGroup&&) = delete;
+            CTaskGroup& operator=(const CTaskGroup&) = delete;
+            CTaskGroup& operator=(CTaskGroup&&) = delete;
+
+          private:
+            std::shared_ptr<CExecutor> m_executor; ///< Executor running the tasks
+            std::mutex m_mutex;                    ///< Protects m_pending
+            std::condition_variable m_condition;   ///< Signals completed tasks
+            size_t m_pending{ 0 };                 ///< Number of scheduled but not completed tasks
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__Executor__*/
@@ -0,0 +1,138 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Memory accounting of ODC subsystems.
+//
+
+#ifndef __ODC__MemoryStats__
+#define __ODC__MemoryStats__
+
+// STD
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+// SYS
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Memory usage of a single subsystem
+        struct SMemoryStat
+        {
+            using container_t = std::vector<SMemoryStat>;
+
+            SMemoryStat()
+            {
+            }
+
+            SMemoryStat(const std::string& _subsystem, size_t _current, size_t _peak)
+                : m_subsystem(_subsystem)
+                , m_current(_current)
+                , m_peak(_peak)
+            {
+            }
+
+            std::string m_subsystem; ///< Name of the subsystem
+            size_t m_current{ 0 };   ///< Current size in bytes
+            size_t m_peak{ 0 };      ///< Peak size in bytes
+        };
+
+        /// \brief Thread safe registry of per subsystem memory usage.
+        /// \details Sizes are estimated by the owners of the objects and reported via update().
+        class CMemoryStats
+        {
+          public:
+            /// \brief Set current size of the subsystem and update its peak
+            void update(const std::string& _subsystem, size_t _bytes)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& stat = m_stats[_subsystem];
+                stat.m_subsystem = _subsystem;
+                stat.m_current = _bytes;
+                stat.m_peak = std::max(stat.m_peak, _bytes);
+            }
+
+            /// \brief Add bytes to the current size of the subsystem and update its peak
+            void add(const std::string& _subsystem, size_t _bytes)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& stat = m_stats[_subsystem];
+                stat.m_subsystem = _subsystem;
+                stat.m_current += _bytes;
+                stat.m_peak = std::max(stat.m_peak, stat.m_current);
+            }
+
+            /// \brief Subtract bytes from the current size of the subsystem
+            void release(const std::string& _subsystem, size_t _bytes)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& stat = m_stats[_subsystem];
+                stat.m_current -= std::min(stat.m_current, _bytes);
+            }
+
+            /// \brief Account bytes to the subsystem as long as the returned pointer or one of its copies is alive
+            /// \details The returned pointer shares ownership of _ptr. The bytes are released when the last copy is
+            /// destroyed.
+            template <class T>
+            static std::shared_ptr<T> track(std::shared_ptr<CMemoryStats> _stats,
+                                            const std::string& _subsystem,
+                                            size_t _bytes,
+                                            std::shared_ptr<T> _ptr)
+            {
+                _stats->add(_subsystem, _bytes);
+                return std::shared_ptr<T>(_ptr.get(),
+                                          [_stats, _subsystem, _bytes, _ptr](T*) { _stats->release(_subsystem, _bytes); });
+            }
+
+            /// \brief Return a snapshot of all subsystems including the process RSS
+            SMemoryStat::container_t get() const
+            {
+                SMemoryStat::container_t result;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    result.reserve(m_stats.size() + 1);
+                    for (const auto& v : m_stats)
+                        result.push_back(v.second);
+                }
+                result.push_back(SMemoryStat("process_rss", currentRSS(), peakRSS()));
+                return result;
+            }
+
+            /// \brief Current resident set size of the process in bytes. Returns 0 if not available.
+            static size_t currentRSS()
+            {
+                std::ifstream statm("/proc/self/statm");
+                size_t size{ 0 };
+                size_t resident{ 0 };
+                if (!(statm >> size >> resident))
+                    return 0;
+                return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            }
+
+            /// \brief Peak resident set size of the process in bytes
+            static size_t peakRSS()
+            {
+                struct rusage usage;
+                if (getrusage(RUSAGE_SELF, &usage) != 0)
+                    return 0;
+#ifdef __APPLE__
+                return static_cast<size_t>(usage.ru_maxrss);
+#else
+                return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+            }
+
+          private:
+            mutable std::mutex m_mutex;
+            std::map<std::string, SMemoryStat> m_stats;
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__MemoryStats__*/
@@ -0,0 +1,94 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "RequestWait.h"
+
+using namespace odc::core;
+using namespace std;
+
+CRequestWait::CRequestWait(size_t _maxErrors)
+    : m_maxErrors(_maxErrors)
+{
+}
+
+void CRequestWait::done()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_cv.notify_all();
+}
+
+void CRequestWait::error(const string& _msg)
+{
+    bool abort{ false };
+    {
+        lock_guard<mutex> lock(m_mutex);
+        abort = setNumErrors(m_numErrors + 1, _msg);
+    }
+    if (abort)
+        m_cv.notify_all();
+}
+
+void CRequestWait::errors(size_t _numErrors, const string& _msg)
+{
+    bool abort{ false };
+    {
+        lock_guard<mutex> lock(m_mutex);
+        abort = setNumErrors(_numErrors, _msg);
+    }
+    if (abort)
+        m_cv.notify_all();
+}
+
+void CRequestWait::abort(const string& _msg)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_numErrors++;
+        m_errorMessage = _msg;
+        m_aborted = true;
+    }
+    m_cv.notify_all();
+}
+
+bool CRequestWait::setNumErrors(size_t _numErrors, const string& _msg)
+{
+    if (_numErrors <= m_numErrors)
+        return false;
+    m_numErrors = _numErrors;
+    m_errorMessage = _msg;
+    const bool abort{ !m_aborted && m_maxErrors > 0 && m_numErrors >= m_maxErrors };
+    m_aborted = m_aborted || abort;
+    return abort;
+}
+
+bool CRequestWait::wait(const chrono::milliseconds& _timeout)
+{
+    unique_lock<mutex> lock(m_mutex);
+    // Predicate protects against spurious wake ups and notifications sent before the wait
+    const bool finished{ m_cv.wait_for(lock, _timeout, [this] { return m_done || m_aborted; }) };
+    m_timedOut = !finished;
+    return m_done && m_numErrors == 0;
+}
+
+bool CRequestWait::timedOut() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_timedOut;
+}
+
+bool CRequestWait::aborted() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_aborted;
+}
+
+string CRequestWait::errorMessage() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_errorMessage;
+}
@@ -0,0 +1,70 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Completion state of asynchronous DDS and FairMQ requests.
+//
+
+#ifndef __ODC__RequestWait__
+#define __ODC__RequestWait__
+
+// STD
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Completion state shared between the thread waiting for a request and the request callbacks.
+        /// \details The waiter is woken up when the request is done or as soon as the number of reported errors
+        /// reaches the threshold, so a request which fails anyway doesn't cost the full timeout. Callbacks hold a
+        /// shared pointer, late callbacks after a timeout don't access a destroyed state.
+        class CRequestWait
+        {
+          public:
+            using ptr_t = std::shared_ptr<CRequestWait>;
+
+            /// \brief Constructor
+            /// \param [in] _maxErrors Number of errors which abort the wait. 0 means that errors don't abort it.
+            CRequestWait(size_t _maxErrors = 1);
+
+            /// \brief Request is done
+            void done();
+            /// \brief Report a single error
+            void error(const std::string& _msg);
+            /// \brief Report the total number of errors counted by the request, e.g. failed tasks
+            void errors(size_t _numErrors, const std::string& _msg);
+            /// \brief Abort the wait regardless of the error threshold, e.g. on shutdown of the waiter
+            void abort(const std::string& _msg);
+
+            /// \brief Wait until the request is done, the error threshold is reached or the timeout expires
+            /// \return True if the request is done without errors
+            bool wait(const std::chrono::milliseconds& _timeout);
+
+            /// \brief True if the wait timed out. Results written by the callbacks must not be used then.
+            bool timedOut() const;
+            /// \brief True if the wait was aborted by the error threshold or by abort()
+            bool aborted() const;
+            /// \brief Message of the last error
+            std::string errorMessage() const;
+
+          private:
+            /// \brief Update the number of errors. Mutex must be locked.
+            /// \return True if the threshold is reached by this update
+            bool setNumErrors(size_t _numErrors, const std::string& _msg);
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_cv;
+            size_t m_maxErrors;         ///< Error threshold, 0 to disable
+            size_t m_numErrors{ 0 };    ///< Number of reported errors
+            std::string m_errorMessage; ///< Last error message
+            bool m_done{ false };       ///< Request is done
+            bool m_aborted{ false };    ///< Error threshold is reached
+            bool m_timedOut{ false };   ///< Wait timed out
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__RequestWait__*/
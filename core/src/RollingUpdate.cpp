@@ -0,0 +1,168 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "RollingUpdate.h"
+// STD
+#include <map>
+#include <set>
+#include <stdexcept>
+// BOOST
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+using namespace odc::core;
+using namespace std;
+namespace bpt = boost::property_tree;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+    const string kNameAttr{ "<xmlattr>.name" };
+    const string kNAttr{ "<xmlattr>.n" };
+
+    bpt::ptree readTopology(const string& _filepath)
+    {
+        bpt::ptree pt;
+        bpt::read_xml(_filepath, pt, bpt::xml_parser::trim_whitespace);
+        return pt;
+    }
+
+    /// \brief Groups of the main element by name
+    map<string, const bpt::ptree*> getGroups(const bpt::ptree& _topology)
+    {
+        map<string, const bpt::ptree*> groups;
+        for (const auto& v : _topology.get_child("topology.main"))
+        {
+            if (v.first == "group")
+                groups[v.second.get<string>(kNameAttr)] = &v.second;
+        }
+        return groups;
+    }
+} // namespace
+
+CRollingUpdatePlan::CRollingUpdatePlan(const string& _currentFile, const string& _targetFile)
+    : m_target(readTopology(_targetFile))
+{
+    const bpt::ptree current(readTopology(_currentFile));
+    const auto currentGroups{ getGroups(current) };
+    const auto targetGroups{ getGroups(m_target) };
+
+    for (const auto& g : targetGroups)
+    {
+        if (currentGroups.count(g.first) == 0)
+            m_incoming.emplace_back(g.first, g.second->get<size_t>(kNAttr, 1));
+    }
+    for (const auto& g : currentGroups)
+    {
+        if (targetGroups.count(g.first) == 0)
+            m_retiring.emplace_back(*g.second, g.second->get<size_t>(kNAttr, 1));
+    }
+    if (m_incoming.empty() || m_retiring.empty())
+    {
+        throw runtime_error("Rolling update requires groups which exist only in the target topology and groups which "
+                            "exist only in the current topology");
+    }
+
+    // Declarations of the current topology are needed by the retiring groups.
+    // A declaration changed in place would restart the retiring tasks as well.
+    const bpt::ptree& targetTopology{ m_target.get_child("topology") };
+    for (const auto& v : current.get_child("topology"))
+    {
+        if (v.first == "<xmlattr>" || v.first == "main")
+            continue;
+
+        const string name{ v.second.get<string>(kNameAttr, "") };
+        bool found{ false };
+        for (const auto& t : targetTopology)
+        {
+            if (t.first != v.first || t.second.get<string>(kNameAttr, "") != name)
+                continue;
+            if (t.second != v.second)
+            {
+                throw runtime_error("Declaration " + v.first + " \"" + name +
+                                    "\" is changed in place. Use a new name for the new version.");
+            }
+            found = true;
+            break;
+        }
+        if (!found)
+            m_declarations.push_back(v);
+    }
+}
+
+size_t CRollingUpdatePlan::numIncoming() const
+{
+    size_t n{ 0 };
+    for (const auto& g : m_incoming)
+        n += g.second;
+    return n;
+}
+
+size_t CRollingUpdatePlan::numRetiring() const
+{
+    size_t n{ 0 };
+    for (const auto& g : m_retiring)
+        n += g.second;
+    return n;
+}
+
+string CRollingUpdatePlan::write(size_t _numAdded, size_t _numRemoved) const
+{
+    bpt::ptree result(m_target);
+    bpt::ptree& topology{ result.get_child("topology") };
+
+    // Declarations are inserted in front of the main element
+    auto mainIt = topology.find("main");
+    for (const auto& v : m_declarations)
+    {
+        topology.insert(topology.to_iterator(mainIt), v);
+    }
+
+    // Incoming groups are filled in the order of the target topology
+    map<string, size_t> incoming;
+    size_t numAdded{ _numAdded };
+    for (const auto& g : m_incoming)
+    {
+        const size_t n{ min(numAdded, g.second) };
+        incoming[g.first] = n;
+        numAdded -= n;
+    }
+
+    bpt::ptree& main{ topology.get_child("main") };
+    for (auto it = main.begin(); it != main.end();)
+    {
+        if (it->first == "group")
+        {
+            auto found = incoming.find(it->second.get<string>(kNameAttr));
+            if (found != incoming.end())
+            {
+                if (found->second == 0)
+                {
+                    it = main.erase(it);
+                    continue;
+                }
+                it->second.put(kNAttr, found->second);
+            }
+        }
+        ++it;
+    }
+
+    // Retiring groups are emptied in the order of the current topology
+    size_t numRemoved{ _numRemoved };
+    for (const auto& g : m_retiring)
+    {
+        const size_t removed{ min(numRemoved, g.second) };
+        numRemoved -= removed;
+        if (removed == g.second)
+            continue;
+        bpt::ptree group(g.first);
+        group.put(kNAttr, g.second - removed);
+        main.push_back(make_pair("group", group));
+    }
+
+    const bfs::path filepath{ bfs::temp_directory_path() / bfs::unique_path("odc-rolling-%%%%-%%%%-%%%%.xml") };
+    bpt::write_xml(filepath.string(), result, locale(), bpt::xml_writer_make_settings<string>(' ', 4));
+    return filepath.string();
+}
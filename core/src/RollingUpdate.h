@@ -0,0 +1,56 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Intermediate topologies of a rolling update.
+//
+
+#ifndef __ODC__RollingUpdate__
+#define __ODC__RollingUpdate__
+
+// STD
+#include <string>
+#include <utility>
+#include <vector>
+// BOOST
+#include <boost/property_tree/ptree.hpp>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Builds intermediate topologies which gradually replace the current topology by the target topology.
+        ///
+        /// Groups of the main element which exist only in the current topology are retiring, groups which exist only
+        /// in the target topology are incoming. Intermediate topologies contain a given number of incoming and retiring
+        /// group instances, everything else is taken from the target topology. Declarations of the current topology
+        /// are kept as long as retiring groups use them.
+        class CRollingUpdatePlan
+        {
+          public:
+            /// \brief Parse the current and the target topology files
+            /// \throw std::runtime_error if topologies can't be updated in a rolling way
+            CRollingUpdatePlan(const std::string& _currentFile, const std::string& _targetFile);
+
+            /// \brief Total number of instances of incoming groups
+            size_t numIncoming() const;
+            /// \brief Total number of instances of retiring groups
+            size_t numRetiring() const;
+
+            /// \brief Write intermediate topology to a temporary file
+            /// \param [in] _numAdded Number of incoming group instances
+            /// \param [in] _numRemoved Number of removed retiring group instances
+            /// \return Path of the topology file
+            std::string write(size_t _numAdded, size_t _numRemoved) const;
+
+          private:
+            using group_t = std::pair<boost::property_tree::ptree, size_t>; ///< Group element and number of instances
+
+            boost::property_tree::ptree m_target;                   ///< Target topology
+            std::vector<std::pair<std::string, size_t>> m_incoming; ///< Incoming group names and instances
+            std::vector<group_t> m_retiring;                        ///< Retiring groups
+            /// Declarations of the current topology which don't exist in the target topology
+            std::vector<boost::property_tree::ptree::value_type> m_declarations;
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__RollingUpdate__*/
@@ -0,0 +1,146 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "ShmMonitor.h"
+#include "Logger.h"
+// STD
+#include <sstream>
+// DDS
+#include <dds/Intercom.h>
+
+using namespace odc::core;
+using namespace std;
+using namespace dds::intercom_api;
+
+//
+// SShmSegmentStat
+//
+
+string SShmSegmentStat::toCmd(const container_t& _stats)
+{
+    // One line per segment with tab separated fields
+    stringstream ss;
+    ss << kShmStatsCmd << "\n";
+    for (const auto& stat : _stats)
+    {
+        ss << stat.m_host << "\t" << stat.m_segment << "\t" << stat.m_size << "\t" << stat.m_free << "\t"
+           << stat.m_largestFree << "\t" << stat.m_timestamp << "\n";
+    }
+    return ss.str();
+}
+
+bool SShmSegmentStat::fromCmd(const string& _cmd, container_t& _stats)
+{
+    stringstream ss(_cmd);
+    string line;
+    if (!getline(ss, line) || line != kShmStatsCmd)
+        return false;
+
+    while (getline(ss, line))
+    {
+        stringstream fields(line);
+        SShmSegmentStat stat;
+        if (getline(fields, stat.m_host, '\t') && getline(fields, stat.m_segment, '\t') &&
+            (fields >> stat.m_size >> stat.m_free >> stat.m_largestFree >> stat.m_timestamp))
+        {
+            _stats.push_back(stat);
+        }
+    }
+    return true;
+}
+
+//
+// CShmMonitor
+//
+
+CShmMonitor::CShmMonitor()
+{
+}
+
+CShmMonitor::~CShmMonitor()
+{
+    stop();
+}
+
+void CShmMonitor::start(const string& _sessionID)
+{
+    stop();
+
+    try
+    {
+        m_service.reset(new CIntercomService());
+        m_customCmd.reset(new CCustomCmd(*m_service));
+        m_service->subscribeOnError([](EErrorCode _code, const string& _msg) {
+            OLOG(ESeverity::error) << "Shared memory monitor: DDS intercom error " << static_cast<int>(_code) << ": "
+                                   << _msg;
+        });
+        m_customCmd->subscribe(
+            [this](const string& _cmd, const string& /*_condition*/, uint64_t /*_senderID*/) { onCmd(_cmd); });
+        m_service->start(_sessionID);
+        OLOG(ESeverity::info) << "Shared memory monitor connected to DDS session " << _sessionID;
+    }
+    catch (exception& _e)
+    {
+        m_customCmd.reset();
+        m_service.reset();
+        OLOG(ESeverity::error) << "Failed to start shared memory monitor: " << _e.what();
+    }
+}
+
+void CShmMonitor::stop()
+{
+    if (m_service != nullptr)
+    {
+        m_service->stop();
+    }
+    m_customCmd.reset();
+    m_service.reset();
+
+    lock_guard<mutex> lock(m_mutex);
+    m_stats.clear();
+}
+
+void CShmMonitor::subscribe(const vector<uint64_t>& _taskIDs, const chrono::milliseconds& _interval)
+{
+    if (m_customCmd == nullptr || _taskIDs.empty())
+        return;
+
+    const string cmd{ kShmSubscribeCmd + " " + to_string(_interval.count()) };
+    for (auto taskID : _taskIDs)
+    {
+        m_customCmd->send(cmd, to_string(taskID));
+    }
+    OLOG(ESeverity::info) << "Shared memory monitor subscribed to " << _taskIDs.size() << " helper tasks";
+}
+
+SShmSegmentStat::container_t CShmMonitor::get() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    SShmSegmentStat::container_t result;
+    result.reserve(m_stats.size());
+    for (const auto& v : m_stats)
+    {
+        result.push_back(v.second);
+    }
+    return result;
+}
+
+void CShmMonitor::onCmd(const string& _cmd)
+{
+    SShmSegmentStat::container_t stats;
+    if (!SShmSegmentStat::fromCmd(_cmd, stats))
+        return;
+
+    lock_guard<mutex> lock(m_mutex);
+    for (const auto& stat : stats)
+    {
+        if (stat.m_size > 0 && stat.m_free < kLowFreeFraction * stat.m_size)
+        {
+            OLOG(ESeverity::warning) << "Low shared memory on " << stat.m_host << ": segment " << stat.m_segment
+                                     << " has " << stat.m_free << " of " << stat.m_size << " bytes free";
+        }
+        m_stats[make_pair(stat.m_host, stat.m_segment)] = stat;
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Collects FairMQ shared memory statistics reported by odc-shm-monitor helper tasks.
+//
+
+#ifndef __ODC__ShmMonitor__
+#define __ODC__ShmMonitor__
+
+// STD
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dds
+{
+    namespace intercom_api
+    {
+        class CIntercomService;
+        class CCustomCmd;
+    } // namespace intercom_api
+} // namespace dds
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Name of the helper executable. Tasks with this executable are considered as shm monitors.
+        const std::string kShmMonitorExe = "odc-shm-monitor";
+        /// \brief Custom command subscribing ODC to the reports of a helper task
+        const std::string kShmSubscribeCmd = "odc-shm-subscribe";
+        /// \brief Header of the custom command holding shared memory statistics
+        const std::string kShmStatsCmd = "odc-shm-stats";
+
+        /// \brief Usage of a single FairMQ shared memory segment
+        struct SShmSegmentStat
+        {
+            using container_t = std::vector<SShmSegmentStat>;
+
+            /// \brief Fraction of the free memory which is not available as a single block, 0 if not probed
+            double fragmentation() const
+            {
+                return (m_free == 0 || m_largestFree == 0) ? 0. : 1. - static_cast<double>(m_largestFree) / m_free;
+            }
+
+            /// \brief Serialize statistics to the custom command sent by the helper task
+            static std::string toCmd(const container_t& _stats);
+            /// \brief Parse custom command sent by the helper task
+            /// \return False if the command is not a shared memory statistics command
+            static bool fromCmd(const std::string& _cmd, container_t& _stats);
+
+            std::string m_host;          ///< Host of the segment
+            std::string m_segment;       ///< Name of the segment
+            uint64_t m_size{ 0 };        ///< Size of the segment in bytes
+            uint64_t m_free{ 0 };        ///< Free memory in bytes
+            uint64_t m_largestFree{ 0 }; ///< Largest allocatable block in bytes, 0 if not probed
+            uint64_t m_timestamp{ 0 };   ///< Time of the measurement in ms since epoch
+        };
+
+        /// \brief Receives shared memory statistics from the helper tasks via DDS custom commands
+        class CShmMonitor
+        {
+          public:
+            CShmMonitor();
+            ~CShmMonitor();
+
+            /// \brief Connect to DDS session and start receiving statistics
+            void start(const std::string& _sessionID);
+            /// \brief Disconnect from DDS session and drop all statistics
+            void stop();
+            /// \brief Request reports from the helper tasks
+            /// \param [in] _taskIDs DDS task IDs of the helper tasks
+            /// \param [in] _interval Reporting interval of the helpers
+            void subscribe(const std::vector<uint64_t>& _taskIDs, const std::chrono::milliseconds& _interval);
+            /// \brief Latest statistics per host and segment
+            SShmSegmentStat::container_t get() const;
+
+            /// \brief Free fraction of the segment below which a warning is logged
+            static constexpr double kLowFreeFraction = 0.1;
+
+            // Disable copy constructors and assignment operators
+            CShmMonitor(const CShmMonitor&) = delete;
+            CShmMonitor(CShmMonitor&&) = delete;
+            CShmMonitor& operator=(const CShmMonitor&) = delete;
+            CShmMonitor& operator=(CShmMonitor&&) = delete;
+
+          private:
+            void onCmd(const std::string& _cmd);
+
+            std::unique_ptr<dds::intercom_api::CIntercomService> m_service; ///< DDS intercom service
+            std::unique_ptr<dds::intercom_api::CCustomCmd> m_customCmd;     ///< DDS custom commands
+            std::map<std::pair<std::string, std::string>, SShmSegmentStat> m_stats; ///< Stats per host and segment
+            mutable std::mutex m_mutex;                                    ///< Protects m_stats
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__ShmMonitor__*/
@@ -0,0 +1,50 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "StateRecorder.h"
+
+using namespace odc::core;
+using namespace std;
+
+CStateRecorder::CStateRecorder(CStateSubscription& _subscription, const set<fair::mq::State>& _states)
+    : m_subscription(_subscription)
+    , m_states(_states)
+{
+    m_listenerID = m_subscription.addListener([this](const SStateChange& _change) { record(_change); });
+}
+
+CStateRecorder::~CStateRecorder()
+{
+    m_subscription.removeListener(m_listenerID);
+}
+
+void CStateRecorder::reset()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_first.clear();
+    m_times.clear();
+}
+
+CStateRecorder::times_t CStateRecorder::first() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_first;
+}
+
+CStateRecorder::times_t CStateRecorder::get(fair::mq::State _state) const
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_times.find(_state);
+    return (it != m_times.end()) ? it->second : times_t();
+}
+
+void CStateRecorder::record(const SStateChange& _change)
+{
+    // Called on the intercom thread, only the first arrival is kept
+    lock_guard<mutex> lock(m_mutex);
+    m_first.emplace(_change.m_taskID, _change.m_timestamp);
+    if (m_states.count(_change.m_state) > 0)
+        m_times[_change.m_state].emplace(_change.m_taskID, _change.m_timestamp);
+}
@@ -0,0 +1,62 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Arrival times of device states received by a state subscription.
+//
+
+#ifndef __ODC__StateRecorder__
+#define __ODC__StateRecorder__
+
+// ODC
+#include "StateSubscription.h"
+// STD
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Records the first arrival time of device states received by a state subscription.
+        /// \details The recorder is registered as a listener of the subscription while it exists, so it doesn't poll
+        /// the FairMQ topology. For each device the first notification after the last reset is kept, as well as the
+        /// first arrival of each of the recorded states.
+        class CStateRecorder
+        {
+          public:
+            using times_t = std::map<uint64_t, uint64_t>; ///< Arrival time in us since epoch by task ID
+
+            /// \brief Constructor
+            /// \param [in] _subscription Subscription delivering the state changes, must outlive the recorder
+            /// \param [in] _states States whose arrival times are recorded in addition to the first notification
+            CStateRecorder(CStateSubscription& _subscription, const std::set<fair::mq::State>& _states = {});
+            ~CStateRecorder();
+
+            /// \brief Drop all recorded times
+            void reset();
+            /// \brief Arrival time of the first notification of each device, whatever the state
+            times_t first() const;
+            /// \brief Arrival time of a recorded state for each device which reported it
+            times_t get(fair::mq::State _state) const;
+
+            // Disable copy constructors and assignment operators
+            CStateRecorder(const CStateRecorder&) = delete;
+            CStateRecorder(CStateRecorder&&) = delete;
+            CStateRecorder& operator=(const CStateRecorder&) = delete;
+            CStateRecorder& operator=(CStateRecorder&&) = delete;
+
+          private:
+            void record(const SStateChange& _change);
+
+            CStateSubscription& m_subscription;         ///< Source of the state changes
+            size_t m_listenerID{ 0 };                   ///< Listener ID in the subscription
+            const std::set<fair::mq::State> m_states;   ///< Recorded states
+            times_t m_first;                            ///< First notification per device
+            std::map<fair::mq::State, times_t> m_times; ///< First arrival per state and device
+            mutable std::mutex m_mutex;                 ///< Protects the times
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__StateRecorder__*/
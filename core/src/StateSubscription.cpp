@@ -0,0 +1,152 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "StateSubscription.h"
+#include "Logger.h"
+// DDS
+#include <dds/Intercom.h>
+// FairMQ
+#include <fairmq/sdk/commands/Commands.h>
+
+using namespace odc::core;
+using namespace std;
+using namespace dds::intercom_api;
+namespace cmds = fair::mq::sdk::cmds;
+
+constexpr chrono::milliseconds CStateSubscription::kSubscriptionInterval;
+
+CStateSubscription::CStateSubscription()
+{
+}
+
+CStateSubscription::~CStateSubscription()
+{
+    stop();
+}
+
+void CStateSubscription::start(const string& _sessionID)
+{
+    stop();
+
+    try
+    {
+        m_service.reset(new CIntercomService());
+        m_customCmd.reset(new CCustomCmd(*m_service));
+        m_service->subscribeOnError([](EErrorCode _code, const string& _msg) {
+            OLOG(ESeverity::error) << "State subscription: DDS intercom error " << static_cast<int>(_code) << ": "
+                                   << _msg;
+        });
+        m_customCmd->subscribe(
+            [this](const string& _cmd, const string& /*_condition*/, uint64_t /*_senderID*/) { onCmd(_cmd); });
+        m_service->start(_sessionID);
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = false;
+        }
+        m_heartbeatThread = thread(&CStateSubscription::heartbeats, this);
+        OLOG(ESeverity::info) << "State subscription connected to DDS session " << _sessionID;
+    }
+    catch (exception& _e)
+    {
+        m_customCmd.reset();
+        m_service.reset();
+        OLOG(ESeverity::error) << "Failed to start state subscription: " << _e.what();
+    }
+}
+
+void CStateSubscription::stop()
+{
+    if (m_heartbeatThread.joinable())
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_heartbeatThread.join();
+    }
+    if (m_service != nullptr)
+    {
+        m_service->stop();
+    }
+    m_customCmd.reset();
+    m_service.reset();
+}
+
+void CStateSubscription::subscribe()
+{
+    if (m_customCmd == nullptr)
+        return;
+
+    // Empty condition addresses all tasks of the session. Tasks which are not FairMQ devices ignore the command.
+    cmds::Cmds request(cmds::make<cmds::SubscribeToStateChange>(kSubscriptionInterval.count()));
+    m_customCmd->send(request.Serialize(), "");
+}
+
+size_t CStateSubscription::addListener(listener_t _listener)
+{
+    lock_guard<mutex> lock(m_listenerMutex);
+    const size_t id{ m_nextListenerID++ };
+    m_listeners.emplace(id, _listener);
+    return id;
+}
+
+void CStateSubscription::removeListener(size_t _id)
+{
+    lock_guard<mutex> lock(m_listenerMutex);
+    m_listeners.erase(_id);
+}
+
+void CStateSubscription::onCmd(const string& _cmd)
+{
+    const uint64_t timestamp(
+        chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count());
+
+    cmds::Cmds received;
+    try
+    {
+        received.Deserialize(_cmd);
+    }
+    catch (exception&)
+    {
+        // Not a FairMQ command
+        return;
+    }
+
+    for (const auto& cmd : received)
+    {
+        if (cmd->GetType() != cmds::Type::state_change)
+            continue;
+
+        const auto& stateChange = static_cast<const cmds::StateChange&>(*cmd);
+        SStateChange change;
+        change.m_taskID = stateChange.GetTaskId();
+        change.m_lastState = stateChange.GetLastState();
+        change.m_state = stateChange.GetCurrentState();
+        change.m_timestamp = timestamp;
+
+        lock_guard<mutex> lock(m_listenerMutex);
+        for (const auto& listener : m_listeners)
+        {
+            listener.second(change);
+        }
+    }
+}
+
+void CStateSubscription::heartbeats()
+{
+    const string heartbeat{ cmds::Cmds(cmds::make<cmds::SubscriptionHeartbeat>(kSubscriptionInterval.count()))
+                                .Serialize() };
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            if (m_cv.wait_for(lock, kSubscriptionInterval / 4, [this] { return m_stop; }))
+                return;
+        }
+        m_customCmd->send(heartbeat, "");
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Subscription to the state changes of the FairMQ devices of a DDS session.
+//
+
+#ifndef __ODC__StateSubscription__
+#define __ODC__StateSubscription__
+
+// STD
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+// FairMQ
+#include <fairmq/States.h>
+
+namespace dds
+{
+    namespace intercom_api
+    {
+        class CIntercomService;
+        class CCustomCmd;
+    } // namespace intercom_api
+} // namespace dds
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Single state change of a device
+        struct SStateChange
+        {
+            uint64_t m_taskID{ 0 };                                    ///< DDS task ID
+            fair::mq::State m_lastState{ fair::mq::State::Undefined }; ///< State before the change
+            fair::mq::State m_state{ fair::mq::State::Undefined };     ///< State after the change
+            uint64_t m_timestamp{ 0 };                                 ///< Arrival time in us since epoch
+        };
+
+        /// \brief Receives every state change of the devices of a DDS session.
+        /// \details The FairMQ topology only keeps the latest state of each device, intermediate states are lost
+        /// between two reads. The FairMQ DDS plugin sends each state change to all subscribers, so this subscription
+        /// sees all of them independently of the topology. Listeners are called on the DDS intercom thread in the
+        /// order of arrival and must return quickly.
+        class CStateSubscription
+        {
+          public:
+            using listener_t = std::function<void(const SStateChange&)>;
+
+            CStateSubscription();
+            ~CStateSubscription();
+
+            /// \brief Connect to DDS session and start receiving notifications
+            void start(const std::string& _sessionID);
+            /// \brief Disconnect from DDS session
+            void stop();
+            /// \brief Subscribe to all devices of the session, e.g. after an activation started new devices.
+            /// Each device replies with its current state.
+            void subscribe();
+
+            /// \brief Register a listener
+            /// \return ID of the listener used by removeListener()
+            size_t addListener(listener_t _listener);
+            /// \brief Remove a listener. It isn't called anymore when the function returns.
+            void removeListener(size_t _id);
+
+            // Disable copy constructors and assignment operators
+            CStateSubscription(const CStateSubscription&) = delete;
+            CStateSubscription(CStateSubscription&&) = delete;
+            CStateSubscription& operator=(const CStateSubscription&) = delete;
+            CStateSubscription& operator=(CStateSubscription&&) = delete;
+
+          private:
+            void onCmd(const std::string& _cmd);
+            void heartbeats();
+
+            /// Devices drop a subscriber without heartbeat within this interval
+            static constexpr std::chrono::milliseconds kSubscriptionInterval{ 600000 };
+
+            std::unique_ptr<dds::intercom_api::CIntercomService> m_service; ///< DDS intercom service
+            std::unique_ptr<dds::intercom_api::CCustomCmd> m_customCmd;     ///< DDS custom commands
+            std::map<size_t, listener_t> m_listeners;                      ///< Listeners by ID
+            size_t m_nextListenerID{ 0 };                                  ///< ID of the next listener
+            std::mutex m_listenerMutex;                                    ///< Protects the listeners
+            std::thread m_heartbeatThread;                                 ///< Sends subscription heartbeats
+            bool m_stop{ false };                                          ///< Stop flag of the heartbeat thread
+            std::mutex m_mutex;                                            ///< Protects the stop flag
+            std::condition_variable m_cv;                                  ///< Wakes up the heartbeat thread
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__StateSubscription__*/
@@ -0,0 +1,181 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "ThroughputSampler.h"
+#include "Logger.h"
+// STD
+#include <algorithm>
+#include <set>
+
+using namespace odc::core;
+using namespace std;
+
+CThroughputSampler::CThroughputSampler(fetch_t _fetch, cancel_t _cancel)
+    : m_fetch(_fetch)
+    , m_cancel(_cancel)
+    , m_generator(random_device()())
+{
+}
+
+CThroughputSampler::~CThroughputSampler()
+{
+    stop();
+}
+
+void CThroughputSampler::start(const SSamplerParams& _params)
+{
+    stop();
+    if (!_params.enabled())
+        return;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = false;
+    }
+    m_counters.clear();
+    m_thread = thread(&CThroughputSampler::run, this, _params);
+    OLOG(ESeverity::info) << "Throughput sampler started with interval " << _params.m_interval.count() << " ms";
+}
+
+void CThroughputSampler::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    // Don't wait for the devices of a running sample
+    if (m_cancel)
+        m_cancel();
+    m_thread.join();
+    OLOG(ESeverity::info) << "Throughput sampler stopped";
+}
+
+bool CThroughputSampler::running() const
+{
+    return m_thread.joinable();
+}
+
+bool CThroughputSampler::stopping() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_stop;
+}
+
+SThroughputSample CThroughputSampler::latest() const
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_latest;
+}
+
+bool CThroughputSampler::waitForSample(uint64_t _lastSequence,
+                                       const chrono::milliseconds& _timeout,
+                                       SThroughputSample& _sample) const
+{
+    unique_lock<mutex> lock(m_mutex);
+    if (!m_cv.wait_for(lock, _timeout, [this, _lastSequence] { return m_latest.m_sequence > _lastSequence; }))
+        return false;
+    _sample = m_latest;
+    return true;
+}
+
+void CThroughputSampler::run(SSamplerParams _params)
+{
+    const double jitter{ max(0.0, min(_params.m_jitter, 1.0)) };
+    uniform_real_distribution<double> distribution(1.0 - jitter, 1.0 + jitter);
+
+    while (true)
+    {
+        // Randomize the interval in order to avoid synchronized load with other pollers
+        const chrono::milliseconds interval(
+            static_cast<chrono::milliseconds::rep>(_params.m_interval.count() * distribution(m_generator)));
+        {
+            unique_lock<mutex> lock(m_mutex);
+            if (m_cv.wait_for(lock, interval, [this] { return m_stop; }))
+                return;
+        }
+
+        try
+        {
+            sample(_params);
+        }
+        catch (exception& _e)
+        {
+            OLOG(ESeverity::error) << "Throughput sampling failed: " << _e.what();
+        }
+    }
+}
+
+void CThroughputSampler::sample(const SSamplerParams& _params)
+{
+    vector<string> keys(_params.m_rateKeys);
+    keys.insert(keys.end(), _params.m_counterKeys.begin(), _params.m_counterKeys.end());
+    const set<string> counterKeys(_params.m_counterKeys.begin(), _params.m_counterKeys.end());
+
+    vector<SDeviceValue> values;
+    if (!m_fetch(keys, values) && values.empty())
+        return;
+
+    const auto now{ clock_t::now() };
+    // Key of the aggregate: scope, name, property key
+    map<tuple<string, string, string>, SThroughputValue> aggregates;
+    for (const auto& v : values)
+    {
+        double value{ 0 };
+        try
+        {
+            value = stod(v.m_value);
+        }
+        catch (exception&)
+        {
+            continue;
+        }
+
+        if (counterKeys.count(v.m_key) > 0)
+        {
+            // Counters are converted to a rate using the previous value of the same device
+            auto& previous = m_counters[make_pair(v.m_deviceID, v.m_key)];
+            const bool first{ previous.second == clock_t::time_point() };
+            const double elapsed{ chrono::duration<double>(now - previous.second).count() };
+            const double counter{ value };
+            value = (first || elapsed <= 0 || counter < previous.first) ? 0 : (counter - previous.first) / elapsed;
+            previous = make_pair(counter, now);
+            if (first)
+                continue;
+        }
+
+        // Devices outside of collections are accounted to their task
+        const auto parent{ v.m_collection.empty() ? make_pair(string("task"), v.m_task)
+                                                  : make_pair(string("collection"), v.m_collection) };
+        for (const auto& scope : { parent, make_pair(string("host"), v.m_host) })
+        {
+            auto& aggregate = aggregates[make_tuple(scope.first, scope.second, v.m_key)];
+            aggregate.m_scope = scope.first;
+            aggregate.m_name = scope.second;
+            aggregate.m_key = v.m_key;
+            aggregate.m_value += value;
+            aggregate.m_numDevices++;
+        }
+    }
+
+    SThroughputSample sample;
+    sample.m_timestamp =
+        chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+    sample.m_values.reserve(aggregates.size());
+    for (auto& v : aggregates)
+    {
+        sample.m_values.push_back(move(v.second));
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        sample.m_sequence = m_latest.m_sequence + 1;
+        m_latest = move(sample);
+    }
+    m_cv.notify_all();
+}
@@ -0,0 +1,140 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Periodic sampling of device throughput properties.
+//
+
+#ifndef __ODC__ThroughputSampler__
+#define __ODC__ThroughputSampler__
+
+// STD
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Structure holds configuration parameters of the throughput sampler
+        struct SSamplerParams
+        {
+            SSamplerParams()
+            {
+            }
+
+            SSamplerParams(const std::vector<std::string>& _rateKeys,
+                           const std::vector<std::string>& _counterKeys,
+                           const std::chrono::milliseconds& _interval,
+                           double _jitter)
+                : m_rateKeys(_rateKeys)
+                , m_counterKeys(_counterKeys)
+                , m_interval(_interval)
+                , m_jitter(_jitter)
+            {
+            }
+
+            /// \brief True if at least one property is configured
+            bool enabled() const
+            {
+                return !m_rateKeys.empty() || !m_counterKeys.empty();
+            }
+
+            std::vector<std::string> m_rateKeys;          ///< Properties holding a rate. Values are summed up.
+            std::vector<std::string> m_counterKeys;       ///< Properties holding a counter. Converted to rate per sec.
+            std::chrono::milliseconds m_interval{ 5000 }; ///< Sampling interval
+            double m_jitter{ 0.1 };                       ///< Maximum relative random deviation of the interval
+        };
+
+        /// \brief Throughput aggregated over the devices of a collection, a task outside of collections or a host
+        struct SThroughputValue
+        {
+            using container_t = std::vector<SThroughputValue>;
+
+            std::string m_scope;      ///< "collection", "task" or "host"
+            std::string m_name;       ///< Path of the collection or task or name of the host
+            std::string m_key;        ///< Property key
+            double m_value{ 0 };      ///< Sum over the devices. Counters are converted to rate per second.
+            size_t m_numDevices{ 0 }; ///< Number of devices contributing to the value
+        };
+
+        /// \brief Single throughput sample of the topology
+        struct SThroughputSample
+        {
+            uint64_t m_sequence{ 0 };               ///< Sequence number of the sample, starts from 1
+            uint64_t m_timestamp{ 0 };              ///< Time of the sample in ms since epoch
+            SThroughputValue::container_t m_values; ///< Aggregated values
+        };
+
+        /// \brief Periodically reads throughput properties of the devices and aggregates them per collection (or task outside of collections) and host
+        class CThroughputSampler
+        {
+          public:
+            /// \brief Raw property value of a single device
+            struct SDeviceValue
+            {
+                std::string m_deviceID;   ///< FairMQ device ID
+                std::string m_task;       ///< Path of the task of the device
+                std::string m_collection; ///< Path of the collection of the device, empty if it's not in a collection
+                std::string m_host;       ///< Host of the device
+                std::string m_key;        ///< Property key
+                std::string m_value;      ///< Property value
+            };
+            using fetch_t = std::function<bool(const std::vector<std::string>&, std::vector<SDeviceValue>&)>;
+            using cancel_t = std::function<void()>;
+
+            /// \brief Constructor
+            /// \param [in] _fetch Function reading the given property keys from all devices
+            /// \param [in] _cancel Function cancelling a running fetch, called by stop()
+            CThroughputSampler(fetch_t _fetch, cancel_t _cancel = nullptr);
+            ~CThroughputSampler();
+
+            /// \brief Start sampling thread. Restarts the sampling if it's already running.
+            void start(const SSamplerParams& _params);
+            /// \brief Stop sampling thread
+            void stop();
+            /// \brief True if the sampling thread is running
+            bool running() const;
+            /// \brief True if stop() was called. Checked by the fetch function before it waits for the devices.
+            bool stopping() const;
+            /// \brief Return the latest sample
+            SThroughputSample latest() const;
+            /// \brief Wait for a sample newer than _lastSequence
+            /// \return False on timeout
+            bool waitForSample(uint64_t _lastSequence,
+                               const std::chrono::milliseconds& _timeout,
+                               SThroughputSample& _sample) const;
+
+            // Disable copy constructors and assignment operators
+            CThroughputSampler(const CThroughputSampler&) = delete;
+            CThroughputSampler(CThroughputSampler&&) = delete;
+            CThroughputSampler& operator=(const CThroughputSampler&) = delete;
+            CThroughputSampler& operator=(CThroughputSampler&&) = delete;
+
+          private:
+            using clock_t = std::chrono::steady_clock;
+
+            void run(SSamplerParams _params);
+            void sample(const SSamplerParams& _params);
+
+            fetch_t m_fetch;                      ///< Reads raw properties from devices
+            cancel_t m_cancel;                    ///< Cancels a running fetch
+            std::thread m_thread;                 ///< Sampling thread
+            bool m_stop{ false };                 ///< Stop flag of the sampling thread
+            std::mt19937 m_generator;             ///< Generator of the interval jitter
+            SThroughputSample m_latest;           ///< Latest sample
+            mutable std::mutex m_mutex;           ///< Protects stop flag and latest sample
+            mutable std::condition_variable m_cv; ///< Signals new samples and stop requests
+            /// Previous counter values per device and key
+            std::map<std::pair<std::string, std::string>, std::pair<double, clock_t::time_point>> m_counters;
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__ThroughputSampler__*/
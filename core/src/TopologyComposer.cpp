@@ -0,0 +1,190 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+//
+
+// ODC
+#include "TopologyComposer.h"
+// STD
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <stdexcept>
+// BOOST
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/regex.hpp>
+
+using namespace odc::core;
+using namespace std;
+namespace bpt = boost::property_tree;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+    const string kNameAttr{ "<xmlattr>.name" };
+
+    string escapeRegex(const string& _str)
+    {
+        static const boost::regex specialChars{ R"([.^$|()\[\]{}*+?\\])" };
+        return boost::regex_replace(_str, specialChars, R"(\\$&)");
+    }
+} // namespace
+
+void CTopologyComposer::set(const string& _name, const string& _topologyFile)
+{
+    const bool valid{ !_name.empty() && all_of(_name.begin(), _name.end(), [](char _c) {
+                          return isalnum(static_cast<unsigned char>(_c)) || _c == '_' || _c == '-';
+                      }) };
+    if (!valid)
+        throw runtime_error("Invalid topology name \"" + _name + "\"");
+
+    auto topologies{ m_topologies };
+    if (_topologyFile.empty())
+    {
+        topologies.erase(_name);
+    }
+    else
+    {
+        bpt::ptree pt;
+        bpt::read_xml(_topologyFile, pt, bpt::xml_parser::trim_whitespace);
+        topologies[_name] = pt;
+    }
+
+    // Validate the combination before the current state is replaced
+    swap(topologies, m_topologies);
+    try
+    {
+        compose();
+    }
+    catch (...)
+    {
+        swap(topologies, m_topologies);
+        throw;
+    }
+
+    m_groups.clear();
+    for (const auto& topology : m_topologies)
+    {
+        vector<string>& groups{ m_groups[topology.first] };
+        for (const auto& v : topology.second.get_child("topology.main"))
+        {
+            if (v.first == "group")
+                groups.push_back(topology.first + "_" + v.second.get<string>(kNameAttr));
+            else if ((v.first == "task" || v.first == "collection") &&
+                     find(groups.begin(), groups.end(), topology.first) == groups.end())
+                groups.push_back(topology.first);
+        }
+    }
+}
+
+void CTopologyComposer::clear()
+{
+    m_topologies.clear();
+    m_groups.clear();
+}
+
+bool CTopologyComposer::empty() const
+{
+    return m_topologies.empty();
+}
+
+bool CTopologyComposer::contains(const string& _name) const
+{
+    return _name.empty() || m_topologies.count(_name) > 0;
+}
+
+string CTopologyComposer::write() const
+{
+    const bfs::path filepath{ bfs::temp_directory_path() / bfs::unique_path("odc-composed-%%%%-%%%%-%%%%.xml") };
+    bpt::write_xml(filepath.string(), compose(), locale(), bpt::xml_writer_make_settings<string>(' ', 4));
+    return filepath.string();
+}
+
+string CTopologyComposer::pathRegex(const string& _name, const string& _path) const
+{
+    if (_name.empty())
+        return _path;
+
+    string groups;
+    auto it = m_groups.find(_name);
+    if (it != m_groups.end())
+    {
+        for (const auto& group : it->second)
+        {
+            groups += (groups.empty() ? "" : "|") + escapeRegex(group);
+        }
+    }
+    // Topology without tasks
+    if (groups.empty())
+        return "(?!)";
+
+    const string prefix{ "main/(" + groups + ")/" };
+    return (_path.empty()) ? prefix + ".*" : "(?=" + prefix + ")(" + _path + ")";
+}
+
+bpt::ptree CTopologyComposer::compose() const
+{
+    bpt::ptree result;
+    bpt::ptree& topology{ result.put_child("topology", bpt::ptree()) };
+    topology.put(kNameAttr, "odc-composed");
+    bpt::ptree main;
+    main.put(kNameAttr, "main");
+
+    std::set<string> groupNames;
+    for (const auto& named : m_topologies)
+    {
+        const string& name{ named.first };
+        for (const auto& v : named.second.get_child("topology"))
+        {
+            if (v.first == "<xmlattr>" || v.first == "main")
+                continue;
+
+            // Declarations are shared by all topologies
+            const string declName{ v.second.get<string>(kNameAttr, "") };
+            auto found = find_if(topology.begin(), topology.end(), [&v, &declName](const bpt::ptree::value_type& _d) {
+                return _d.first == v.first && _d.second.get<string>(kNameAttr, "") == declName;
+            });
+            if (found == topology.end())
+            {
+                topology.push_back(v);
+            }
+            else if (found->second != v.second)
+            {
+                throw runtime_error("Declaration " + v.first + " \"" + declName + "\" of topology " + name +
+                                    " differs from the declaration of another topology");
+            }
+        }
+
+        // Tasks and collections outside of groups are placed into a group named after the topology
+        bpt::ptree group;
+        group.put(kNameAttr, name);
+        group.put("<xmlattr>.n", 1);
+        const size_t numAttributes{ group.size() };
+        for (const auto& v : named.second.get_child("topology.main"))
+        {
+            if (v.first == "task" || v.first == "collection")
+                group.push_back(v);
+        }
+        if (group.size() > numAttributes)
+        {
+            if (!groupNames.insert(name).second)
+                throw runtime_error("Group " + name + " exists in several topologies");
+            main.push_back(make_pair("group", group));
+        }
+
+        for (const auto& v : named.second.get_child("topology.main"))
+        {
+            if (v.first != "group")
+                continue;
+            bpt::ptree renamed(v.second);
+            const string groupName{ name + "_" + v.second.get<string>(kNameAttr) };
+            renamed.put(kNameAttr, groupName);
+            if (!groupNames.insert(groupName).second)
+                throw runtime_error("Group " + groupName + " exists in several topologies");
+            main.push_back(make_pair("group", renamed));
+        }
+    }
+
+    topology.push_back(make_pair("main", main));
+    return result;
+}
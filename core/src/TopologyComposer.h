@@ -0,0 +1,64 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Several named topologies combined into one DDS topology.
+//
+
+#ifndef __ODC__TopologyComposer__
+#define __ODC__TopologyComposer__
+
+// STD
+#include <map>
+#include <string>
+#include <vector>
+// BOOST
+#include <boost/property_tree/ptree.hpp>
+
+namespace odc
+{
+    namespace core
+    {
+        /// \brief Combines named topologies into a single topology which is activated in one DDS session.
+        ///
+        /// DDS runs one topology per session. Each named topology becomes a set of groups of the combined topology:
+        /// tasks and collections of its main element are placed into a group with the name of the topology, its
+        /// groups are renamed to `<name>_<group>`. Declarations are shared, a declaration of the same name must be
+        /// identical in all topologies. Adding, replacing or removing a named topology doesn't change the tasks of
+        /// the other topologies, so a DDS update leaves them running.
+        class CTopologyComposer
+        {
+          public:
+            /// \brief Add or replace a named topology
+            /// \param [in] _name Name of the topology: letters, digits, '_' and '-'
+            /// \param [in] _topologyFile Topology file. If empty, the named topology is removed.
+            /// \throw std::runtime_error if the topology can't be read or conflicts with the other topologies
+            void set(const std::string& _name, const std::string& _topologyFile);
+            /// \brief Remove all named topologies
+            void clear();
+
+            /// \brief True if no named topology is set
+            bool empty() const;
+            /// \brief True if a named topology is set. Empty name is always known.
+            bool contains(const std::string& _name) const;
+
+            /// \brief Write the combined topology to a new temporary file
+            /// \return Path of the topology file. The caller removes the file when it isn't needed anymore.
+            std::string write() const;
+
+            /// \brief Regular expression matching the paths of all tasks of a named topology
+            /// \param [in] _name Name of the topology
+            /// \param [in] _path Optional regular expression further restricting the tasks. It is matched against the
+            /// paths in the combined topology, i.e. with the renamed groups, and is not translated.
+            std::string pathRegex(const std::string& _name, const std::string& _path = "") const;
+
+          private:
+            /// \brief Combine the named topologies
+            /// \throw std::runtime_error if declarations or group names conflict
+            boost::property_tree::ptree compose() const;
+
+            std::map<std::string, boost::property_tree::ptree> m_topologies; ///< Topology file content per name
+            std::map<std::string, std::vector<std::string>> m_groups;        ///< Group names per topology
+        };
+    } // namespace core
+} // namespace odc
+
+#endif /*__ODC__TopologyComposer__*/
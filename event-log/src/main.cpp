@@ -0,0 +1,193 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Reader of the binary device event logs written by the control service.
+// Reconstructs the timeline of a session and the transition durations per device.
+//
+
+// ODC
+#include "EventLog.h"
+// STD
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+// BOOST
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/positional_options.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+using namespace std;
+using namespace odc::core;
+namespace bpo = boost::program_options;
+
+namespace
+{
+    string stateName(uint8_t _state)
+    {
+        return fair::mq::GetStateName(static_cast<fair::mq::State>(_state));
+    }
+
+    string transitionName(uint8_t _transition)
+    {
+        return fair::mq::GetTransitionName(static_cast<fair::mq::Transition>(_transition));
+    }
+
+    /// \brief Milliseconds between two timestamps in microseconds
+    double msec(uint64_t _from, uint64_t _to)
+    {
+        return static_cast<double>(_to - _from) / 1000.;
+    }
+
+    /// \brief Duration statistics of transitions into a state
+    struct SDurationStat
+    {
+        void add(double _duration, uint64_t _taskID)
+        {
+            m_count++;
+            m_sum += _duration;
+            m_min = min(m_min, _duration);
+            if (_duration > m_max)
+            {
+                m_max = _duration;
+                m_slowestTaskID = _taskID;
+            }
+        }
+
+        size_t m_count{ 0 };
+        double m_sum{ 0. };
+        double m_min{ numeric_limits<double>::max() };
+        double m_max{ 0. };
+        uint64_t m_slowestTaskID{ 0 };
+    };
+
+    void printTimeline(const vector<SDeviceEvent>& _events, uint64_t _taskID)
+    {
+        const uint64_t start{ _events.front().m_timestamp };
+        cout << fixed << setprecision(3);
+        for (const auto& event : _events)
+        {
+            if (event.m_type == EEventType::transition)
+            {
+                cout << "+" << setw(12) << msec(start, event.m_timestamp) << " ms  run " << event.m_runID
+                     << "  request " << transitionName(event.m_newState) << endl;
+            }
+            else if (_taskID == 0 || event.m_taskID == _taskID)
+            {
+                cout << "+" << setw(12) << msec(start, event.m_timestamp) << " ms  run " << event.m_runID << "  task "
+                     << event.m_taskID << ": " << stateName(event.m_oldState) << " -> " << stateName(event.m_newState)
+                     << endl;
+            }
+        }
+    }
+
+    void printDurations(const vector<SDeviceEvent>& _events, uint64_t _taskID, bool _perDevice)
+    {
+        // Duration of a state change is measured from the last transition request
+        uint64_t requestTimestamp{ 0 };
+        map<uint8_t, SDurationStat> stats;
+        map<uint64_t, vector<pair<uint8_t, double>>> devices;
+        for (const auto& event : _events)
+        {
+            if (event.m_type == EEventType::transition)
+            {
+                requestTimestamp = event.m_timestamp;
+                continue;
+            }
+            if (requestTimestamp == 0 || (_taskID != 0 && event.m_taskID != _taskID))
+                continue;
+
+            const double duration{ msec(requestTimestamp, event.m_timestamp) };
+            stats[event.m_newState].add(duration, event.m_taskID);
+            if (_perDevice)
+                devices[event.m_taskID].emplace_back(event.m_newState, duration);
+        }
+
+        cout << fixed << setprecision(3);
+        if (_perDevice)
+        {
+            for (const auto& device : devices)
+            {
+                cout << "task " << device.first << ":";
+                for (const auto& change : device.second)
+                {
+                    cout << " " << stateName(change.first) << " " << change.second << " ms;";
+                }
+                cout << endl;
+            }
+            cout << endl;
+        }
+
+        for (const auto& stat : stats)
+        {
+            const SDurationStat& s{ stat.second };
+            cout << setw(20) << left << stateName(stat.first) << right << " devices: " << setw(6) << s.m_count
+                 << "  min: " << setw(10) << s.m_min << " ms  mean: " << setw(10) << (s.m_sum / s.m_count)
+                 << " ms  max: " << setw(10) << s.m_max << " ms (task " << s.m_slowestTaskID << ")" << endl;
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        string filepath;
+        string mode;
+        uint64_t taskID;
+        bool perDevice;
+
+        // Generic options
+        bpo::options_description options("odc-event-log options");
+        options.add_options()("help,h", "Produce help message");
+        options.add_options()("file", bpo::value<string>(&filepath), "Event log file");
+        options.add_options()("mode",
+                              bpo::value<string>(&mode)->default_value("timeline"),
+                              "Output mode: timeline or durations");
+        options.add_options()(
+            "task", bpo::value<uint64_t>(&taskID)->default_value(0), "Only events of this task ID, 0 for all tasks");
+        options.add_options()("devices",
+                              bpo::bool_switch(&perDevice)->default_value(false),
+                              "Print transition durations of each device in durations mode");
+
+        bpo::positional_options_description positional;
+        positional.add("file", 1);
+
+        // Parsing command-line
+        bpo::variables_map vm;
+        bpo::store(bpo::command_line_parser(argc, argv).options(options).positional(positional).run(), vm);
+        bpo::notify(vm);
+
+        if (vm.count("help") || filepath.empty())
+        {
+            cout << options;
+            return EXIT_SUCCESS;
+        }
+
+        const vector<SDeviceEvent> events{ CEventLog::read(filepath) };
+        if (events.empty())
+        {
+            cout << "No events recorded" << endl;
+            return EXIT_SUCCESS;
+        }
+
+        if (mode == "durations")
+        {
+            printDurations(events, taskID, perDevice);
+        }
+        else
+        {
+            printTimeline(events, taskID);
+        }
+    }
+    catch (exception& _e)
+    {
+        cerr << _e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
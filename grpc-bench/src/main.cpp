@@ -0,0 +1,163 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Benchmark of the gRPC message compression of detailed state change replies.
+// Builds replies for a given number of devices and compresses them with the zlib settings used by gRPC.
+//
+
+// gRPC
+#include "odc.pb.h"
+// STD
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// BOOST
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+// ZLIB
+#include <zlib.h>
+
+using namespace std;
+namespace bpo = boost::program_options;
+
+namespace
+{
+    /// \brief Detailed reply of a Running topology shaped like ex-dds-topology-infinite.xml: collections of a
+    /// sampler, a sink and 10 processors. Task IDs are random 64 bit values like the hashes used by DDS.
+    odc::StateChangeReply buildReply(size_t _numDevices)
+    {
+        odc::StateChangeReply reply;
+        auto general = reply.mutable_reply();
+        general->set_msg("Start done");
+        general->set_status(odc::ReplyStatus::SUCCESS);
+        general->set_exectime(1234);
+        general->set_runid(1);
+        general->set_sessionid("6c4a2e8f-0b1d-4e7a-9c3f-2d5b8a1e7f90");
+        general->set_topologyversion(1);
+        general->set_partitionid("benchmark");
+
+        mt19937_64 random(42);
+        const size_t collectionSize{ 12 };
+        for (size_t i = 0; i < _numDevices; ++i)
+        {
+            const size_t index{ i % collectionSize };
+            const string task{ (index == 0) ? "Sampler" : (index == 1) ? "Sink" : "Processor_" + to_string(index - 2) };
+            auto device = reply.add_devices();
+            device->set_id(random());
+            device->set_state("RUNNING");
+            device->set_path("main/EPNGroup/EPNCollection_" + to_string(i / collectionSize) + "/" + task);
+        }
+        return reply;
+    }
+
+    /// \brief Compress like gRPC: default level, gzip or zlib (deflate) format
+    string compress(const string& _data, bool _gzip)
+    {
+        z_stream stream{};
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (_gzip ? 16 : 0), 8, Z_DEFAULT_STRATEGY) !=
+            Z_OK)
+            throw runtime_error("deflateInit2 failed");
+        string result(deflateBound(&stream, _data.size()), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(_data.data()));
+        stream.avail_in = _data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+        stream.avail_out = result.size();
+        const int status{ deflate(&stream, Z_FINISH) };
+        result.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (status != Z_STREAM_END)
+            throw runtime_error("deflate failed");
+        return result;
+    }
+
+    string decompress(const string& _data, size_t _size, bool _gzip)
+    {
+        z_stream stream{};
+        if (inflateInit2(&stream, 15 | (_gzip ? 16 : 0)) != Z_OK)
+            throw runtime_error("inflateInit2 failed");
+        string result(_size, '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(_data.data()));
+        stream.avail_in = _data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+        stream.avail_out = result.size();
+        const int status{ inflate(&stream, Z_FINISH) };
+        inflateEnd(&stream);
+        if (status != Z_STREAM_END)
+            throw runtime_error("inflate failed");
+        return result;
+    }
+
+    /// \brief Average time of a function in ms
+    template <typename Func_t>
+    double measure(size_t _repeat, Func_t _func)
+    {
+        const auto start{ chrono::steady_clock::now() };
+        for (size_t i = 0; i < _repeat; ++i)
+        {
+            _func();
+        }
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / _repeat;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        vector<size_t> numDevices;
+        size_t repeat{ 0 };
+
+        bpo::options_description options("odc-grpc-bench options");
+        options.add_options()("help,h", "Produce help message");
+        options.add_options()("devices",
+                              bpo::value<vector<size_t>>(&numDevices)
+                                  ->multitoken()
+                                  ->default_value({ 1000, 10000, 100000 }, "1000 10000 100000"),
+                              "Numbers of devices in the reply");
+        options.add_options()(
+            "repeat", bpo::value<size_t>(&repeat)->default_value(10), "Number of repetitions of each measurement");
+
+        bpo::variables_map vm;
+        bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+        bpo::notify(vm);
+
+        if (vm.count("help"))
+        {
+            cout << options;
+            return EXIT_SUCCESS;
+        }
+        if (repeat == 0)
+            throw runtime_error("Number of repetitions must be positive");
+
+        cout << setw(8) << "devices" << setw(10) << "algorithm" << setw(12) << "size [KB]" << setw(10) << "ratio"
+             << setw(16) << "compress [ms]" << setw(18) << "decompress [ms]" << endl;
+        cout << fixed;
+        for (auto n : numDevices)
+        {
+            const string raw{ buildReply(n).SerializeAsString() };
+            cout << setw(8) << n << setw(10) << "none" << setw(12) << setprecision(1) << raw.size() / 1024.
+                 << setw(10) << setprecision(2) << 1. << setw(16) << "-" << setw(18) << "-" << endl;
+            for (bool gzip : { true, false })
+            {
+                string compressed;
+                const double compressTime{ measure(repeat, [&]() { compressed = compress(raw, gzip); }) };
+                const double decompressTime{ measure(repeat, [&]() { decompress(compressed, raw.size(), gzip); }) };
+                cout << setw(8) << n << setw(10) << (gzip ? "gzip" : "deflate") << setw(12) << setprecision(1)
+                     << compressed.size() / 1024. << setw(10) << setprecision(2)
+                     << static_cast<double>(raw.size()) / compressed.size() << setw(16) << setprecision(2)
+                     << compressTime << setw(18) << decompressTime << endl;
+            }
+        }
+    }
+    catch (exception& _e)
+    {
+        cerr << "Benchmark failed: " << _e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -13,24 +13,39 @@ CGrpcControlClient::CGrpcControlClient(shared_ptr<grpc::Channel> channel)
 {
 }
 
+void CGrpcControlClient::setPartitionID(const std::string& _partitionID)
+{
+    m_partitionID = _partitionID;
+}
+
+void CGrpcControlClient::setCompressionParams(const SCompressionParams& _params)
+{
+    m_compressionParams = _params;
+}
+
 std::string CGrpcControlClient::requestInitialize(const SInitializeParams& _params)
 {
     odc::InitializeRequest request;
+    request.set_partitionid(m_partitionID);
     request.set_runid(_params.m_runID);
     request.set_sessionid(_params.m_sessionID);
     odc::GeneralReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = m_stub->Initialize(&context, request, &reply);
     return GetReplyString(status, reply);
 }
 
 std::string CGrpcControlClient::requestSubmit(const SSubmitParams& _params)
 {
-    // Submit parameters are not used for the request.
+    // Only the topology is sent, other submit parameters are configured in the server.
 
     odc::SubmitRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_topology(_params.m_topologyFile);
     odc::GeneralReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = m_stub->Submit(&context, request, &reply);
     return GetReplyString(status, reply);
 }
@@ -38,9 +53,13 @@ std::string CGrpcControlClient::requestSubmit(const SSubmitParams& _params)
 std::string CGrpcControlClient::requestActivate(const SActivateParams& _params)
 {
     odc::ActivateRequest request;
+    request.set_partitionid(m_partitionID);
     request.set_topology(_params.m_topologyFile);
+    request.set_name(_params.m_topologyName);
+    request.set_colocate(_params.m_colocate);
     odc::GeneralReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = m_stub->Activate(&context, request, &reply);
     return GetReplyString(status, reply);
 }
@@ -55,6 +74,20 @@ std::string CGrpcControlClient::requestDownscale(const SUpdateParams& _params)
     return updateRequest(_params);
 }
 
+std::string CGrpcControlClient::requestRollingUpdate(const SUpdateParams& _params)
+{
+    odc::RollingUpdateRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_topology(_params.m_topologyFile);
+    request.set_wavesize(_params.m_waveSize);
+    request.set_mincapacity(_params.m_minCapacity);
+    odc::RollingUpdateReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->RollingUpdate(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
 std::string CGrpcControlClient::requestConfigure(const SDeviceParams& _params)
 {
     return stateChangeRequest<odc::ConfigureRequest>(_params, &odc::ODC::Stub::Configure);
@@ -83,12 +116,155 @@ std::string CGrpcControlClient::requestTerminate(const SDeviceParams& _params)
 std::string CGrpcControlClient::requestShutdown()
 {
     odc::ShutdownRequest request;
+    request.set_partitionid(m_partitionID);
     odc::GeneralReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = m_stub->Shutdown(&context, request, &reply);
     return GetReplyString(status, reply);
 }
 
+std::string CGrpcControlClient::requestSetProperty(const SSetPropertyParams& _params)
+{
+    odc::SetPropertyRequest request;
+    request.set_partitionid(m_partitionID);
+    for (const auto& property : _params.m_properties)
+    {
+        auto p = request.add_properties();
+        p->set_key(property.first);
+        p->set_value(property.second);
+    }
+    request.set_path(_params.m_path);
+    request.set_force(_params.m_force);
+    odc::GeneralReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->SetProperty(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestSaveConfig(const SSaveConfigParams& _params)
+{
+    odc::SaveConfigRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_name(_params.m_name);
+    for (const auto& params : _params.m_entries)
+    {
+        auto entry = request.add_entries();
+        entry->set_path(params.m_path);
+        for (const auto& property : params.m_properties)
+        {
+            auto p = entry->add_properties();
+            p->set_key(property.first);
+            p->set_value(property.second);
+        }
+    }
+    odc::GeneralReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->SaveConfig(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestApplyConfig(const SApplyConfigParams& _params)
+{
+    odc::ApplyConfigRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_name(_params.m_name);
+    request.set_force(_params.m_force);
+    odc::GeneralReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->ApplyConfig(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestGetProperties(const SGetPropertiesParams& _params)
+{
+    odc::GetPropertiesRequest request;
+    request.set_partitionid(m_partitionID);
+    for (const auto& key : _params.m_keys)
+    {
+        request.add_keys(key);
+    }
+    request.set_path(_params.m_path);
+    request.set_detailed(!_params.m_aggregate);
+    request.set_topologyversion(_params.m_topologyVersion);
+    odc::GetPropertiesReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->GetProperties(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestGetTopology(const SGetTopologyParams& _params)
+{
+    odc::TopologyRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_topologyversion(_params.m_topologyVersion);
+    odc::TopologyReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->GetTopology(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestMetrics()
+{
+    odc::MetricsRequest request;
+    request.set_partitionid(m_partitionID);
+    odc::MetricsReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->GetMetrics(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestDiagnostics()
+{
+    odc::DiagnosticsRequest request;
+    request.set_partitionid(m_partitionID);
+    odc::DiagnosticsReply reply;
+    grpc::ClientContext context;
+    setupContext(context, request);
+    grpc::Status status = m_stub->Diagnostics(&context, request, &reply);
+    return GetReplyString(status, reply);
+}
+
+std::string CGrpcControlClient::requestThroughput(size_t _numSamples)
+{
+    odc::ThroughputRequest request;
+    request.set_partitionid(m_partitionID);
+    request.set_maxsamples(_numSamples);
+    grpc::ClientContext context;
+    setupContext(context, request);
+    std::unique_ptr<grpc::ClientReader<odc::ThroughputReply>> reader(m_stub->SubscribeThroughput(&context, request));
+    std::stringstream ss;
+    odc::ThroughputReply reply;
+    while (reader->Read(&reply))
+    {
+        ss << reply.DebugString() << endl;
+    }
+    grpc::Status status = reader->Finish();
+    if (!status.ok())
+    {
+        ss << "RPC failed with error code " << status.error_code() << ": " << status.error_message() << endl;
+    }
+    return ss.str();
+}
+
+void CGrpcControlClient::setupContext(grpc::ClientContext& _context, const google::protobuf::Message& _request) const
+{
+    // Server compresses large replies with the algorithm selected by the client
+    _context.AddMetadata(kCompressionMetadata, m_compressionParams.m_algorithm);
+    if (_request.ByteSizeLong() < m_compressionParams.m_threshold)
+        return;
+    if (m_compressionParams.m_algorithm == "gzip")
+        _context.set_compression_algorithm(GRPC_COMPRESS_GZIP);
+    else if (m_compressionParams.m_algorithm == "deflate")
+        _context.set_compression_algorithm(GRPC_COMPRESS_DEFLATE);
+}
+
 template <typename Reply_t>
 std::string CGrpcControlClient::GetReplyString(const grpc::Status& _status, const Reply_t& _reply)
 {
@@ -107,9 +283,11 @@ std::string CGrpcControlClient::GetReplyString(const grpc::Status& _status, cons
 std::string CGrpcControlClient::updateRequest(const SUpdateParams& _params)
 {
     odc::UpdateRequest request;
+    request.set_partitionid(m_partitionID);
     request.set_topology(_params.m_topologyFile);
     odc::GeneralReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = m_stub->Update(&context, request, &reply);
     return GetReplyString(status, reply);
 }
@@ -121,12 +299,33 @@ std::string CGrpcControlClient::stateChangeRequest(const SDeviceParams& _params,
     odc::StateChangeRequest* stateChange = new odc::StateChangeRequest();
     stateChange->set_path(_params.m_path);
     stateChange->set_detailed(_params.m_detailed);
+    stateChange->set_topologyversion(_params.m_topologyVersion);
+    stateChange->set_partitionid(m_partitionID);
+    stateChange->set_softdeadline(_params.m_stragglers.m_softDeadline.count());
+    switch (_params.m_stragglers.m_policy)
+    {
+        case EStragglerPolicy::isolate:
+            stateChange->set_stragglers(odc::StragglerPolicy::STRAGGLER_ISOLATE);
+            break;
+        case EStragglerPolicy::terminate:
+            stateChange->set_stragglers(odc::StragglerPolicy::STRAGGLER_TERMINATE);
+            break;
+        default:
+            stateChange->set_stragglers(odc::StragglerPolicy::STRAGGLER_FAIL);
+            break;
+    }
+    stateChange->set_maxstragglers(_params.m_stragglers.m_maxFraction);
+    stateChange->set_startdelay(_params.m_startDelay.count());
+    stateChange->set_retries(_params.m_retry.m_maxRetries);
+    stateChange->set_retrybackoff(_params.m_retry.m_backoff.count());
+    stateChange->set_topologyname(_params.m_topologyName);
 
     Request_t request;
     request.set_allocated_request(stateChange);
 
     odc::StateChangeReply reply;
     grpc::ClientContext context;
+    setupContext(context, request);
     grpc::Status status = (m_stub.get()->*_stubFunc)(&context, request, &reply);
     return GetReplyString(status, reply);
 }
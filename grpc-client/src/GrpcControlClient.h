@@ -21,20 +21,35 @@ class CGrpcControlClient : public odc::core::CCliServiceHelper<CGrpcControlClien
   public:
     CGrpcControlClient(std::shared_ptr<grpc::Channel> channel);
 
+    /// \brief Set partition ID sent with each request
+    void setPartitionID(const std::string& _partitionID);
+    /// \brief Set compression of large requests and the algorithm requested for large replies
+    void setCompressionParams(const odc::core::SCompressionParams& _params);
+
     std::string requestInitialize(const odc::core::SInitializeParams& _params);
     std::string requestSubmit(const odc::core::SSubmitParams& _params);
     std::string requestActivate(const odc::core::SActivateParams& _params);
     std::string requestUpscale(const odc::core::SUpdateParams& _params);
     std::string requestDownscale(const odc::core::SUpdateParams& _params);
+    std::string requestRollingUpdate(const odc::core::SUpdateParams& _params);
     std::string requestConfigure(const odc::core::SDeviceParams& _params);
     std::string requestStart(const odc::core::SDeviceParams& _params);
     std::string requestStop(const odc::core::SDeviceParams& _params);
     std::string requestReset(const odc::core::SDeviceParams& _params);
     std::string requestTerminate(const odc::core::SDeviceParams& _params);
     std::string requestShutdown();
+    std::string requestSetProperty(const odc::core::SSetPropertyParams& _params);
+    std::string requestSaveConfig(const odc::core::SSaveConfigParams& _params);
+    std::string requestApplyConfig(const odc::core::SApplyConfigParams& _params);
+    std::string requestGetProperties(const odc::core::SGetPropertiesParams& _params);
+    std::string requestGetTopology(const odc::core::SGetTopologyParams& _params);
+    std::string requestMetrics();
+    std::string requestDiagnostics();
+    std::string requestThroughput(size_t _numSamples);
 
   private:
     std::string updateRequest(const odc::core::SUpdateParams& _params);
+    void setupContext(grpc::ClientContext& _context, const google::protobuf::Message& _request) const;
     template <typename Request_t, typename StubFunc_t>
     std::string stateChangeRequest(const odc::core::SDeviceParams& _params, StubFunc_t _stubFunc);
 
@@ -44,6 +59,8 @@ class CGrpcControlClient : public odc::core::CCliServiceHelper<CGrpcControlClien
 
   private:
     std::unique_ptr<odc::ODC::Stub> m_stub;
+    std::string m_partitionID;                        ///< Partition ID, empty for the default partition
+    odc::core::SCompressionParams m_compressionParams; ///< Compression of large messages
 };
 
 #endif /* defined(__ODC__GrpcControlClient__) */
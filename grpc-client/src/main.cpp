@@ -21,6 +21,7 @@ int main(int argc, char** argv)
     try
     {
         string host;
+        string partitionID;
         SInitializeParams initializeParams;
         SActivateParams activateParams;
         SUpdateParams upscaleParams;
@@ -28,11 +29,16 @@ int main(int argc, char** argv)
         CLogger::SConfig logConfig;
         SDeviceParams recoDeviceParams;
         SDeviceParams qcDeviceParams;
+        SStragglerParams stragglerParams;
+        SRetryParams retryParams;
+        SCompressionParams compressionParams;
 
         // Generic options
         bpo::options_description options("grpc-client options");
         options.add_options()("help,h", "Produce help message");
         CCliHelper::addHostOptions(options, "localhost:50051", host);
+        options.add_options()(
+            "partition", bpo::value<string>(&partitionID)->default_value(""), "Partition ID, empty for the default one");
         CCliHelper::addInitializeOptions(options, SInitializeParams(1000, ""), initializeParams);
         string defaultTopo(kODCDataDir + "/ex-dds-topology-infinite.xml");
         CCliHelper::addActivateOptions(options, SActivateParams(defaultTopo), activateParams);
@@ -42,6 +48,9 @@ int main(int argc, char** argv)
         CCliHelper::addDownscaleOptions(options, SUpdateParams(defaultDownscaleTopo), downscaleParams);
         CCliHelper::addLogOptions(options, CLogger::SConfig(), logConfig);
         CCliHelper::addDeviceOptions(options, SDeviceParams(), recoDeviceParams, SDeviceParams(), qcDeviceParams);
+        CCliHelper::addStragglerOptions(options, SStragglerParams(), stragglerParams);
+        CCliHelper::addRetryOptions(options, SRetryParams(), retryParams);
+        CCliHelper::addCompressionOptions(options, SCompressionParams(), compressionParams);
 
         // Parsing command-line
         bpo::variables_map vm;
@@ -65,12 +74,16 @@ int main(int argc, char** argv)
         }
 
         CGrpcControlClient control(grpc::CreateChannel(host, grpc::InsecureChannelCredentials()));
+        control.setPartitionID(partitionID);
+        control.setCompressionParams(compressionParams);
         control.setInitializeParams(initializeParams);
         control.setActivateParams(activateParams);
         control.setUpscaleParams(upscaleParams);
         control.setDownscaleParams(downscaleParams);
         control.setRecoDeviceParams(recoDeviceParams);
         control.setQCDeviceParams(qcDeviceParams);
+        control.setStragglerParams(stragglerParams);
+        control.setRetryParams(retryParams);
         control.run();
     }
     catch (exception& _e)
@@ -36,3 +36,38 @@ void CGrpcControlServer::setSubmitParams(const odc::core::SSubmitParams& _params
 {
     m_service->setSubmitParams(_params);
 }
+
+void CGrpcControlServer::setSamplerParams(const odc::core::SSamplerParams& _params)
+{
+    m_service->setSamplerParams(_params);
+}
+
+void CGrpcControlServer::setEventLogDir(const std::string& _dir)
+{
+    m_service->setEventLogDir(_dir);
+}
+
+void CGrpcControlServer::setConfigDir(const std::string& _dir)
+{
+    m_service->setConfigDir(_dir);
+}
+
+void CGrpcControlServer::setAgentCheckInterval(const std::chrono::milliseconds& _interval)
+{
+    m_service->setAgentCheckInterval(_interval);
+}
+
+void CGrpcControlServer::setShmMonitorInterval(const std::chrono::milliseconds& _interval)
+{
+    m_service->setShmMonitorInterval(_interval);
+}
+
+void CGrpcControlServer::setExchangeTiming(bool _enabled)
+{
+    m_service->setExchangeTiming(_enabled);
+}
+
+void CGrpcControlServer::setCompressionParams(const odc::core::SCompressionParams& _params)
+{
+    m_service->setCompressionParams(_params);
+}
@@ -23,6 +23,13 @@ namespace odc
 
             void setTimeout(const std::chrono::seconds& _timeout);
             void setSubmitParams(const odc::core::SSubmitParams& _params);
+            void setSamplerParams(const odc::core::SSamplerParams& _params);
+            void setEventLogDir(const std::string& _dir);
+            void setConfigDir(const std::string& _dir);
+            void setAgentCheckInterval(const std::chrono::milliseconds& _interval);
+            void setShmMonitorInterval(const std::chrono::milliseconds& _interval);
+            void setExchangeTiming(bool _enabled);
+            void setCompressionParams(const odc::core::SCompressionParams& _params);
 
           private:
             std::shared_ptr<CGrpcControlService> m_service; ///< Service for request processing
@@ -4,6 +4,14 @@
 
 // DDS
 #include "GrpcControlService.h"
+#include "TimeMeasure.h"
+// STD
+#include <cctype>
+#include <future>
+#include <set>
+// BOOST
+#include <boost/asio/ip/address.hpp>
+#include <boost/regex.hpp>
 
 using namespace odc;
 using namespace odc::core;
@@ -11,13 +19,19 @@ using namespace odc::grpc;
 using namespace std;
 
 CGrpcControlService::CGrpcControlService()
-    : m_service(make_shared<CControlService>())
 {
+    // Default partition always exists, clients without partitions don't have to initialize it for read requests
+    getService("");
 }
 
 void CGrpcControlService::setTimeout(const std::chrono::seconds& _timeout)
 {
-    m_service->setTimeout(_timeout);
+    lock_guard<mutex> lock(m_mutex);
+    m_timeout = _timeout;
+    for (auto& v : m_services)
+    {
+        v.second->setTimeout(_timeout);
+    }
 }
 
 void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _params)
@@ -25,13 +39,148 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
     m_submitParams = _params;
 }
 
+void CGrpcControlService::setSamplerParams(const odc::core::SSamplerParams& _params)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_samplerParams = _params;
+    for (auto& v : m_services)
+    {
+        v.second->setSamplerParams(_params);
+    }
+}
+
+void CGrpcControlService::setEventLogDir(const std::string& _dir)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_eventLogDir = _dir;
+    for (auto& v : m_services)
+    {
+        v.second->setEventLogDir(_dir);
+    }
+}
+
+void CGrpcControlService::setConfigDir(const std::string& _dir)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_configDir = _dir;
+    for (auto& v : m_services)
+    {
+        v.second->setConfigDir(_dir);
+    }
+}
+
+void CGrpcControlService::setAgentCheckInterval(const std::chrono::milliseconds& _interval)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_agentCheckInterval = _interval;
+    for (auto& v : m_services)
+    {
+        v.second->setAgentCheckInterval(_interval);
+    }
+}
+
+void CGrpcControlService::setShmMonitorInterval(const std::chrono::milliseconds& _interval)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_shmMonitorInterval = _interval;
+    for (auto& v : m_services)
+    {
+        v.second->setShmMonitorInterval(_interval);
+    }
+}
+
+void CGrpcControlService::setExchangeTiming(bool _enabled)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_exchangeTiming = _enabled;
+    for (auto& v : m_services)
+    {
+        v.second->setExchangeTiming(_enabled);
+    }
+}
+
+void CGrpcControlService::setCompressionParams(const odc::core::SCompressionParams& _params)
+{
+    m_compressionParams = _params;
+}
+
+shared_ptr<CControlService> CGrpcControlService::getService(const string& _partitionID)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_services.find(_partitionID);
+    if (it != m_services.end())
+        return it->second;
+
+    // Partitions are created by Initialize or Submit
+    auto service = make_shared<CControlService>();
+    service->setTimeout(m_timeout);
+    service->setSamplerParams(m_samplerParams);
+    service->setEventLogDir(m_eventLogDir);
+    service->setConfigDir(m_configDir);
+    service->setAgentCheckInterval(m_agentCheckInterval);
+    service->setShmMonitorInterval(m_shmMonitorInterval);
+    service->setExchangeTiming(m_exchangeTiming);
+    m_services.emplace(_partitionID, service);
+    return service;
+}
+
+shared_ptr<CControlService> CGrpcControlService::findService(const string& _partitionID) const
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_services.find(_partitionID);
+    return (it == m_services.end()) ? nullptr : it->second;
+}
+
+void CGrpcControlService::removeService(const string& _partitionID)
+{
+    // Default partition is kept
+    if (_partitionID.empty())
+        return;
+    lock_guard<mutex> lock(m_mutex);
+    m_services.erase(_partitionID);
+}
+
+::grpc::Status CGrpcControlService::unknownPartition(const string& _partitionID)
+{
+    return ::grpc::Status(::grpc::StatusCode::NOT_FOUND,
+                          "Unknown partition " + _partitionID + ", it has to be created by Initialize or Submit");
+}
+
+::grpc::Status CGrpcControlService::selectPartitions(const odc::BulkStateChangeRequest& _request,
+                                                     vector<string>& _partitions) const
+{
+    set<string> result(_request.partitionids().begin(), _request.partitionids().end());
+    if (!_request.selector().empty())
+    {
+        boost::regex selector;
+        try
+        {
+            selector.assign(_request.selector());
+        }
+        catch (boost::regex_error& _e)
+        {
+            return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                                  "Invalid partition selector " + _request.selector() + ": " + _e.what());
+        }
+        lock_guard<mutex> lock(m_mutex);
+        for (const auto& v : m_services)
+        {
+            if (boost::regex_match(v.first, selector))
+                result.insert(v.first);
+        }
+    }
+    _partitions.assign(result.begin(), result.end());
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status CGrpcControlService::Initialize(::grpc::ServerContext* context,
                                                const odc::InitializeRequest* request,
                                                odc::GeneralReply* response)
 {
     SInitializeParams params{ request->runid(), request->sessionid() };
-    SReturnValue value = m_service->execInitialize(params);
-    setupGeneralReply(response, value);
+    SReturnValue value = getService(request->partitionid())->execInitialize(params);
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -39,8 +188,11 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                            const odc::SubmitRequest* request,
                                            odc::GeneralReply* response)
 {
-    SReturnValue value = m_service->execSubmit(m_submitParams);
-    setupGeneralReply(response, value);
+    SSubmitParams params{ m_submitParams };
+    params.m_topologyFile = request->topology();
+    SReturnValue value = getService(request->partitionid())->execSubmit(params);
+    setupSubmitReply(response, value, request->partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -48,9 +200,13 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                              const odc::ActivateRequest* request,
                                              odc::GeneralReply* response)
 {
-    SActivateParams params{ request->topology() };
-    SReturnValue value = m_service->execActivate(params);
-    setupGeneralReply(response, value);
+    SActivateParams params{ request->topology(), request->name(), request->colocate() };
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execActivate(params);
+    setupActivateReply(response, value, request->partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -59,8 +215,32 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                            odc::GeneralReply* response)
 {
     SUpdateParams params{ request->topology() };
-    SReturnValue value = m_service->execUpdate(params);
-    setupGeneralReply(response, value);
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execUpdate(params);
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::RollingUpdate(::grpc::ServerContext* context,
+                                                  const odc::RollingUpdateRequest* request,
+                                                  odc::RollingUpdateReply* response)
+{
+    // Unset fields of proto3 are 0: replace one instance per wave and keep the full initial capacity.
+    // Wave size 0 would select a full update.
+    SUpdateParams params{ request->topology(), 1, 1.0 };
+    if (request->wavesize() > 0)
+        params.m_waveSize = request->wavesize();
+    if (request->mincapacity() > 0)
+        params.m_minCapacity = request->mincapacity();
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execUpdate(params);
+    setupRollingUpdateReply(response, value, request->partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -68,9 +248,18 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                               const odc::ConfigureRequest* request,
                                               odc::StateChangeReply* response)
 {
-    SDeviceParams params{ request->request().path(), request->request().detailed() };
-    SReturnValue value = m_service->execConfigure(params);
-    setupStateChangeReply(response, value);
+    SDeviceParams params{ request->request().path(),
+                          request->request().detailed(),
+                          request->request().topologyversion() };
+    params.m_stragglers = stragglerParams(request->request());
+    params.m_retry = retryParams(request->request());
+    params.m_topologyName = request->request().topologyname();
+    auto service = findService(request->request().partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->request().partitionid());
+    SReturnValue value = service->execConfigure(params);
+    setupStateChangeReply(response, value, request->request().partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -78,9 +267,19 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                           const odc::StartRequest* request,
                                           odc::StateChangeReply* response)
 {
-    SDeviceParams params{ request->request().path(), request->request().detailed() };
-    SReturnValue value = m_service->execStart(params);
-    setupStateChangeReply(response, value);
+    SDeviceParams params{ request->request().path(),
+                          request->request().detailed(),
+                          request->request().topologyversion() };
+    params.m_stragglers = stragglerParams(request->request());
+    params.m_retry = retryParams(request->request());
+    params.m_topologyName = request->request().topologyname();
+    params.m_startDelay = chrono::milliseconds(request->request().startdelay());
+    auto service = findService(request->request().partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->request().partitionid());
+    SReturnValue value = service->execStart(params);
+    setupStateChangeReply(response, value, request->request().partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -88,9 +287,18 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                          const odc::StopRequest* request,
                                          odc::StateChangeReply* response)
 {
-    SDeviceParams params{ request->request().path(), request->request().detailed() };
-    SReturnValue value = m_service->execStop(params);
-    setupStateChangeReply(response, value);
+    SDeviceParams params{ request->request().path(),
+                          request->request().detailed(),
+                          request->request().topologyversion() };
+    params.m_stragglers = stragglerParams(request->request());
+    params.m_retry = retryParams(request->request());
+    params.m_topologyName = request->request().topologyname();
+    auto service = findService(request->request().partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->request().partitionid());
+    SReturnValue value = service->execStop(params);
+    setupStateChangeReply(response, value, request->request().partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -98,9 +306,18 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                           const odc::ResetRequest* request,
                                           odc::StateChangeReply* response)
 {
-    SDeviceParams params{ request->request().path(), request->request().detailed() };
-    SReturnValue value = m_service->execReset(params);
-    setupStateChangeReply(response, value);
+    SDeviceParams params{ request->request().path(),
+                          request->request().detailed(),
+                          request->request().topologyversion() };
+    params.m_stragglers = stragglerParams(request->request());
+    params.m_retry = retryParams(request->request());
+    params.m_topologyName = request->request().topologyname();
+    auto service = findService(request->request().partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->request().partitionid());
+    SReturnValue value = service->execReset(params);
+    setupStateChangeReply(response, value, request->request().partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -108,9 +325,18 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                               const odc::TerminateRequest* request,
                                               odc::StateChangeReply* response)
 {
-    SDeviceParams params{ request->request().path(), request->request().detailed() };
-    SReturnValue value = m_service->execTerminate(params);
-    setupStateChangeReply(response, value);
+    SDeviceParams params{ request->request().path(),
+                          request->request().detailed(),
+                          request->request().topologyversion() };
+    params.m_stragglers = stragglerParams(request->request());
+    params.m_retry = retryParams(request->request());
+    params.m_topologyName = request->request().topologyname();
+    auto service = findService(request->request().partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->request().partitionid());
+    SReturnValue value = service->execTerminate(params);
+    setupStateChangeReply(response, value, request->request().partitionid());
+    compressReply(context, *response);
     return ::grpc::Status::OK;
 }
 
@@ -118,12 +344,380 @@ void CGrpcControlService::setSubmitParams(const odc::core::SSubmitParams& _param
                                              const odc::ShutdownRequest* request,
                                              odc::GeneralReply* response)
 {
-    SReturnValue value = m_service->execShutdown();
-    setupGeneralReply(response, value);
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execShutdown();
+    // Partition is gone with its DDS session
+    removeService(request->partitionid());
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::SetProperty(::grpc::ServerContext* context,
+                                                const odc::SetPropertyRequest* request,
+                                                odc::GeneralReply* response)
+{
+    SDeviceProperties::properties_t properties;
+    if (!request->key().empty())
+        properties.emplace_back(request->key(), request->value());
+    for (const auto& property : request->properties())
+    {
+        properties.emplace_back(property.key(), property.value());
+    }
+    SSetPropertyParams params{ properties, request->path(), request->force() };
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execSetProperty(params);
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::SaveConfig(::grpc::ServerContext* context,
+                                               const odc::SaveConfigRequest* request,
+                                               odc::GeneralReply* response)
+{
+    SSaveConfigParams params;
+    params.m_name = request->name();
+    for (const auto& entry : request->entries())
+    {
+        SDeviceProperties::properties_t properties;
+        for (const auto& property : entry.properties())
+        {
+            properties.emplace_back(property.key(), property.value());
+        }
+        params.m_entries.emplace_back(properties, entry.path());
+    }
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execSaveConfig(params);
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::ApplyConfig(::grpc::ServerContext* context,
+                                                const odc::ApplyConfigRequest* request,
+                                                odc::GeneralReply* response)
+{
+    SApplyConfigParams params{ request->name(), request->force() };
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execApplyConfig(params);
+    setupGeneralReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::GetProperties(::grpc::ServerContext* context,
+                                                  const odc::GetPropertiesRequest* request,
+                                                  odc::GetPropertiesReply* response)
+{
+    SGetPropertiesParams params{ vector<string>(request->keys().begin(), request->keys().end()),
+                                 request->path(),
+                                 !request->detailed(),
+                                 request->topologyversion() };
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execGetProperties(params);
+    setupGetPropertiesReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::GetTopology(::grpc::ServerContext* context,
+                                                const odc::TopologyRequest* request,
+                                                odc::TopologyReply* response)
+{
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execGetTopology(SGetTopologyParams(request->topologyversion()));
+    setupTopologyReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::GetMetrics(::grpc::ServerContext* context,
+                                               const odc::MetricsRequest* request,
+                                               odc::MetricsReply* response)
+{
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execGetMetrics();
+    setupMetricsReply(response, value, request->partitionid());
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::Diagnostics(::grpc::ServerContext* context,
+                                                const odc::DiagnosticsRequest* request,
+                                                odc::DiagnosticsReply* response)
+{
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    SReturnValue value = service->execDiagnostics();
+    setupDiagnosticsReply(response, value, request->partitionid());
+
+    // Other partitions only report their sessions, requests and locks
+    map<string, shared_ptr<CControlService>> services;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        services = m_services;
+    }
+    for (const auto& v : services)
+    {
+        if (v.first != request->partitionid())
+            setupPartitionDiagnostics(response->add_partitions(), v.first, v.second->diagnostics());
+    }
+    compressReply(context, *response);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::SubscribeThroughput(::grpc::ServerContext* context,
+                                                        const odc::ThroughputRequest* request,
+                                                        ::grpc::ServerWriter<odc::ThroughputReply>* writer)
+{
+    auto service = findService(request->partitionid());
+    if (service == nullptr)
+        return unknownPartition(request->partitionid());
+    uint64_t sequence{ 0 };
+    uint32_t numSamples{ 0 };
+    while (!context->IsCancelled() && (request->maxsamples() == 0 || numSamples < request->maxsamples()))
+    {
+        // Wake up regularly in order to check whether the client is still there
+        SThroughputSample sample;
+        if (!service->waitForThroughputSample(sequence, chrono::seconds(1), sample))
+            continue;
+
+        sequence = sample.m_sequence;
+        odc::ThroughputReply reply;
+        setupThroughputReply(&reply, sample);
+        if (!writer->Write(reply))
+            break;
+        numSamples++;
+    }
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status CGrpcControlService::BulkConfigure(::grpc::ServerContext* context,
+                                                  const odc::BulkStateChangeRequest* request,
+                                                  odc::BulkStateChangeReply* response)
+{
+    const ::grpc::Status status{ bulkStateChange(*request, response, &CControlService::execConfigure) };
+    compressReply(context, *response);
+    return status;
+}
+
+::grpc::Status CGrpcControlService::BulkStart(::grpc::ServerContext* context,
+                                              const odc::BulkStateChangeRequest* request,
+                                              odc::BulkStateChangeReply* response)
+{
+    const ::grpc::Status status{ bulkStateChange(*request, response, &CControlService::execStart) };
+    compressReply(context, *response);
+    return status;
+}
+
+::grpc::Status CGrpcControlService::BulkStop(::grpc::ServerContext* context,
+                                             const odc::BulkStateChangeRequest* request,
+                                             odc::BulkStateChangeReply* response)
+{
+    const ::grpc::Status status{ bulkStateChange(*request, response, &CControlService::execStop) };
+    compressReply(context, *response);
+    return status;
+}
+
+::grpc::Status CGrpcControlService::BulkReset(::grpc::ServerContext* context,
+                                              const odc::BulkStateChangeRequest* request,
+                                              odc::BulkStateChangeReply* response)
+{
+    const ::grpc::Status status{ bulkStateChange(*request, response, &CControlService::execReset) };
+    compressReply(context, *response);
+    return status;
+}
+
+::grpc::Status CGrpcControlService::BulkTerminate(::grpc::ServerContext* context,
+                                                  const odc::BulkStateChangeRequest* request,
+                                                  odc::BulkStateChangeReply* response)
+{
+    const ::grpc::Status status{ bulkStateChange(*request, response, &CControlService::execTerminate) };
+    compressReply(context, *response);
+    return status;
+}
+
+void CGrpcControlService::compressReply(::grpc::ServerContext* _context, const google::protobuf::Message& _reply) const
+{
+    // Compression costs more than it saves on the loopback interface
+    if (isLocalPeer(_context->peer()))
+        return;
+
+    // Client may select the algorithm of the call, e.g. disable compression on a fast link
+    string algorithm{ m_compressionParams.m_algorithm };
+    const auto& metadata = _context->client_metadata();
+    auto it = metadata.find(kCompressionMetadata);
+    if (it != metadata.end())
+        algorithm = string(it->second.data(), it->second.size());
+
+    if (_reply.ByteSizeLong() < m_compressionParams.m_threshold)
+        return;
+    if (algorithm == "gzip")
+        _context->set_compression_algorithm(GRPC_COMPRESS_GZIP);
+    else if (algorithm == "deflate")
+        _context->set_compression_algorithm(GRPC_COMPRESS_DEFLATE);
+}
+
+bool CGrpcControlService::isLocalPeer(const string& _peer)
+{
+    // Newer gRPC versions percent-encode the address, e.g. ipv6:%5B%3A%3A1%5D:5000
+    string peer;
+    for (size_t i = 0; i < _peer.size(); ++i)
+    {
+        if (_peer[i] == '%' && i + 2 < _peer.size() && isxdigit(static_cast<unsigned char>(_peer[i + 1])) &&
+            isxdigit(static_cast<unsigned char>(_peer[i + 2])))
+        {
+            peer += static_cast<char>(stoi(_peer.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else
+        {
+            peer += _peer[i];
+        }
+    }
+
+    if (peer.compare(0, 5, "unix:") == 0)
+        return true;
+
+    // Host is followed by the port: ipv4:<address>:<port> or ipv6:[<address>]:<port>
+    string host;
+    if (peer.compare(0, 5, "ipv4:") == 0)
+    {
+        host = peer.substr(5, peer.rfind(':') - 5);
+    }
+    else if (peer.compare(0, 6, "ipv6:[") == 0)
+    {
+        const size_t end{ peer.find(']') };
+        if (end == string::npos)
+            return false;
+        host = peer.substr(6, end - 6);
+        // Scope ID of a link-local address
+        host = host.substr(0, host.find('%'));
+    }
+    else
+    {
+        return false;
+    }
+
+    boost::system::error_code ec;
+    const auto address{ boost::asio::ip::make_address(host, ec) };
+    if (ec)
+        return false;
+    // IPv4 clients of a dual-stack socket have an IPv4-mapped address, e.g. ::ffff:127.0.0.1
+    if (address.is_v6() && address.to_v6().is_v4_mapped())
+        return boost::asio::ip::make_address_v4(boost::asio::ip::v4_mapped, address.to_v6()).is_loopback();
+    return address.is_loopback();
+}
+
+::grpc::Status CGrpcControlService::bulkStateChange(const odc::BulkStateChangeRequest& _request,
+                                                    odc::BulkStateChangeReply* _response,
+                                                    StateChangeFunc_t _func)
+{
+    STimeMeasure<std::chrono::milliseconds> measure;
+    SDeviceParams params{ _request.path(), _request.detailed() };
+    params.m_stragglers = stragglerParams(_request);
+    params.m_retry = retryParams(_request);
+    params.m_topologyName = _request.topologyname();
+    params.m_startDelay = chrono::milliseconds(_request.startdelay());
+    vector<string> partitions;
+    const ::grpc::Status status{ selectPartitions(_request, partitions) };
+    if (!status.ok())
+        return status;
+
+    // Partitions are independent: run the requests concurrently, total time is the time of the slowest partition
+    vector<future<SReturnValue>> futures;
+    futures.reserve(partitions.size());
+    for (const auto& partitionID : partitions)
+    {
+        auto service = findService(partitionID);
+        futures.push_back(async(launch::async, [service, params, _func, partitionID]() {
+            if (service == nullptr)
+            {
+                return SReturnValue(
+                    EStatusCode::error, "", 0, SError(124, "Unknown partition " + partitionID), 0, "", nullptr);
+            }
+            return ((*service).*_func)(params);
+        }));
+    }
+
+    size_t numSucceeded{ 0 };
+    for (size_t i = 0; i < partitions.size(); ++i)
+    {
+        SReturnValue value{ futures[i].get() };
+        if (value.m_statusCode == EStatusCode::ok)
+            numSucceeded++;
+        setupStateChangeReply(_response->add_partitions(), value, partitions[i]);
+    }
+
+    const bool success{ numSucceeded == partitions.size() };
+    const string msg{ to_string(numSucceeded) + " of " + to_string(partitions.size()) + " partitions succeeded" };
+    SReturnValue combined;
+    if (success)
+    {
+        combined = SReturnValue(EStatusCode::ok, msg, measure.duration(), SError(), 0, "");
+    }
+    else
+    {
+        combined = SReturnValue(EStatusCode::error, "", measure.duration(), SError(125, msg), 0, "");
+    }
+    setupGeneralReply(_response->mutable_reply(), combined, "");
     return ::grpc::Status::OK;
 }
 
-void CGrpcControlService::setupGeneralReply(odc::GeneralReply* _response, const SReturnValue& _value)
+template <typename Request_t>
+SStragglerParams CGrpcControlService::stragglerParams(const Request_t& _request)
+{
+    SStragglerParams params;
+    params.m_softDeadline = chrono::seconds(_request.softdeadline());
+    switch (_request.stragglers())
+    {
+        case odc::StragglerPolicy::STRAGGLER_ISOLATE:
+            params.m_policy = EStragglerPolicy::isolate;
+            break;
+        case odc::StragglerPolicy::STRAGGLER_TERMINATE:
+            params.m_policy = EStragglerPolicy::terminate;
+            break;
+        default:
+            params.m_policy = EStragglerPolicy::fail;
+            break;
+    }
+    // Unset fraction keeps the default
+    if (_request.maxstragglers() > 0)
+        params.m_maxFraction = _request.maxstragglers();
+    return params;
+}
+
+template <typename Request_t>
+SRetryParams CGrpcControlService::retryParams(const Request_t& _request)
+{
+    SRetryParams params;
+    // Each retry can take the full request timeout, so the number is clamped
+    params.m_maxRetries = min<size_t>(_request.retries(), kMaxRetries);
+    // Unset backoff keeps the default
+    if (_request.retrybackoff() > 0)
+        params.m_backoff = chrono::milliseconds(_request.retrybackoff());
+    return params;
+}
+
+void CGrpcControlService::setupGeneralReply(odc::GeneralReply* _response,
+                                            const SReturnValue& _value,
+                                            const string& _partitionID)
 {
     if (_value.m_statusCode == EStatusCode::ok)
     {
@@ -143,13 +737,52 @@ void CGrpcControlService::setupGeneralReply(odc::GeneralReply* _response, const
     _response->set_runid(_value.m_runID);
     _response->set_sessionid(_value.m_sessionID);
     _response->set_exectime(_value.m_execTime);
+    _response->set_topologyversion(_value.m_topologyVersion);
+    _response->set_topologyhash(_value.m_topologyHash);
+    _response->set_partitionid(_partitionID);
+}
+
+void CGrpcControlService::setupSubmitReply(odc::GeneralReply* _response,
+                                           const odc::core::SReturnValue& _value,
+                                           const std::string& _partitionID)
+{
+    setupGeneralReply(_response, _value, _partitionID);
+    if (_value.m_details != nullptr)
+    {
+        const SAgentPlan& plan{ _value.m_details->m_agentPlan };
+        auto reply = _response->mutable_plan();
+        reply->set_agents(plan.m_numAgents);
+        reply->set_slots(plan.m_numSlots);
+        reply->set_tasks(plan.m_numTasks);
+        reply->set_collections(plan.m_numCollections);
+    }
+}
+
+void CGrpcControlService::setupActivateReply(odc::GeneralReply* _response,
+                                             const odc::core::SReturnValue& _value,
+                                             const std::string& _partitionID)
+{
+    setupGeneralReply(_response, _value, _partitionID);
+    if (_value.m_details != nullptr)
+    {
+        for (const auto& latency : _value.m_details->m_launchLatencies)
+        {
+            setupLaunchLatency(_response->add_launch(), latency);
+        }
+        for (const auto& channel : _value.m_details->m_colocatedChannels)
+        {
+            setupColocatedChannel(_response->add_colocated(), channel);
+        }
+    }
 }
 
-void CGrpcControlService::setupStateChangeReply(odc::StateChangeReply* _response, const odc::core::SReturnValue& _value)
+void CGrpcControlService::setupStateChangeReply(odc::StateChangeReply* _response,
+                                                const odc::core::SReturnValue& _value,
+                                                const std::string& _partitionID)
 {
     // Protobuf message takes the ownership and deletes the object
     odc::GeneralReply* generalResponse = new odc::GeneralReply();
-    setupGeneralReply(generalResponse, _value);
+    setupGeneralReply(generalResponse, _value, _partitionID);
     _response->set_allocated_reply(generalResponse);
 
     if (_value.m_details != nullptr)
@@ -162,5 +795,318 @@ void CGrpcControlService::setupStateChangeReply(odc::StateChangeReply* _response
             device->set_id(state.m_status.taskId);
             device->set_state(fair::mq::GetStateName(state.m_status.state));
         }
+        for (const auto& stat : _value.m_details->m_shmStats)
+        {
+            setupShmSegment(_response->add_shm(), stat);
+        }
+        for (const auto& path : _value.m_details->m_excludedCollections)
+        {
+            _response->add_excluded(path);
+        }
+        const SStartSkew& skew{ _value.m_details->m_startSkew };
+        if (skew.m_targetTime > 0)
+        {
+            auto startSkew = _response->mutable_startskew();
+            startSkew->set_devices(skew.m_numDevices);
+            startSkew->set_targettime(skew.m_targetTime);
+            startSkew->set_median(skew.m_median);
+            startSkew->set_p90(skew.m_p90);
+            startSkew->set_p99(skew.m_p99);
+            startSkew->set_max(skew.m_max);
+            startSkew->set_late(skew.m_numLate);
+        }
+        for (const auto& latency : _value.m_details->m_propertyLatencies)
+        {
+            setupPropertyLatency(_response->add_exchange(), latency);
+        }
+    }
+}
+
+void CGrpcControlService::setupGetPropertiesReply(odc::GetPropertiesReply* _response,
+                                                  const odc::core::SReturnValue& _value,
+                                                  const std::string& _partitionID)
+{
+    // Protobuf message takes the ownership and deletes the object
+    odc::GeneralReply* generalResponse = new odc::GeneralReply();
+    setupGeneralReply(generalResponse, _value, _partitionID);
+    _response->set_allocated_reply(generalResponse);
+
+    if (_value.m_details == nullptr)
+        return;
+
+    for (const auto& deviceProperties : _value.m_details->m_deviceProperties)
+    {
+        auto device = _response->add_devices();
+        device->set_id(deviceProperties.m_deviceID);
+        device->set_path(deviceProperties.m_path);
+        for (const auto& p : deviceProperties.m_properties)
+        {
+            auto property = device->add_properties();
+            property->set_key(p.first);
+            property->set_value(p.second);
+        }
+    }
+
+    for (const auto& a : _value.m_details->m_propertyAggregates)
+    {
+        auto aggregate = _response->add_aggregates();
+        aggregate->set_key(a.m_key);
+        aggregate->set_distinct(a.m_numDistinct);
+        aggregate->set_devices(a.m_numDevices);
+        aggregate->set_numeric(a.m_numeric);
+        aggregate->set_min(a.m_min);
+        aggregate->set_max(a.m_max);
+        for (const auto& v : a.m_values)
+        {
+            auto value = aggregate->add_values();
+            value->set_value(v.first);
+            value->set_count(v.second);
+        }
+    }
+
+    for (const auto& id : _value.m_details->m_failedDevices)
+    {
+        _response->add_failed(id);
+    }
+}
+
+void CGrpcControlService::setupRollingUpdateReply(odc::RollingUpdateReply* _response,
+                                                  const odc::core::SReturnValue& _value,
+                                                  const std::string& _partitionID)
+{
+    // Protobuf message takes the ownership and deletes the object
+    odc::GeneralReply* generalResponse = new odc::GeneralReply();
+    setupGeneralReply(generalResponse, _value, _partitionID);
+    _response->set_allocated_reply(generalResponse);
+
+    if (_value.m_details == nullptr)
+        return;
+
+    for (const auto& w : _value.m_details->m_waves)
+    {
+        auto wave = _response->add_waves();
+        wave->set_index(w.m_index);
+        wave->set_added(w.m_numAdded);
+        wave->set_removed(w.m_numRemoved);
+        wave->set_capacity(w.m_capacity);
+        wave->set_activatetime(w.m_activateTime);
+        wave->set_starttime(w.m_startTime);
+        wave->set_retiretime(w.m_retireTime);
+        wave->set_success(w.m_success);
+    }
+}
+
+void CGrpcControlService::setupTopologyReply(odc::TopologyReply* _response,
+                                             const odc::core::SReturnValue& _value,
+                                             const std::string& _partitionID)
+{
+    // Protobuf message takes the ownership and deletes the object
+    odc::GeneralReply* generalResponse = new odc::GeneralReply();
+    setupGeneralReply(generalResponse, _value, _partitionID);
+    _response->set_allocated_reply(generalResponse);
+
+    if (_value.m_details == nullptr)
+        return;
+
+    const STopologyStructure& topology{ _value.m_details->m_topology };
+    *_response->mutable_paths() = { topology.m_paths.begin(), topology.m_paths.end() };
+    *_response->mutable_hosts() = { topology.m_hosts.begin(), topology.m_hosts.end() };
+    *_response->mutable_properties() = { topology.m_properties.begin(), topology.m_properties.end() };
+    for (const auto& g : topology.m_groups)
+    {
+        auto group = _response->add_groups();
+        group->set_name(g.m_name);
+        group->set_n(g.m_n);
+    }
+    for (const auto& c : topology.m_collections)
+    {
+        auto collection = _response->add_collections();
+        collection->set_id(c.m_id);
+        collection->set_path(c.m_path);
+        collection->set_tasks(c.m_numTasks);
+    }
+    for (const auto& t : topology.m_tasks)
+    {
+        auto task = _response->add_tasks();
+        task->set_id(t.m_id);
+        task->set_path(t.m_path);
+        task->set_collectionid(t.m_collectionID);
+        task->set_host(t.m_host);
+        for (const auto& p : t.m_properties)
+        {
+            auto property = task->add_properties();
+            property->set_name(p.m_name);
+            property->set_read(p.m_read);
+            property->set_write(p.m_write);
+        }
+    }
+}
+
+void CGrpcControlService::setupMetricsReply(odc::MetricsReply* _response,
+                                            const odc::core::SReturnValue& _value,
+                                            const std::string& _partitionID)
+{
+    // Protobuf message takes the ownership and deletes the object
+    odc::GeneralReply* generalResponse = new odc::GeneralReply();
+    setupGeneralReply(generalResponse, _value, _partitionID);
+    _response->set_allocated_reply(generalResponse);
+
+    if (_value.m_details != nullptr)
+    {
+        for (const auto& stat : _value.m_details->m_memoryStats)
+        {
+            auto memory = _response->add_memory();
+            memory->set_subsystem(stat.m_subsystem);
+            memory->set_current(stat.m_current);
+            memory->set_peak(stat.m_peak);
+        }
+        setupThroughputReply(_response->mutable_throughput(), _value.m_details->m_throughput);
+        for (const auto& stat : _value.m_details->m_shmStats)
+        {
+            setupShmSegment(_response->add_shm(), stat);
+        }
+        for (const auto& latency : _value.m_details->m_launchLatencies)
+        {
+            setupLaunchLatency(_response->add_launch(), latency);
+        }
+        for (const auto& latency : _value.m_details->m_propertyLatencies)
+        {
+            setupPropertyLatency(_response->add_exchange(), latency);
+        }
+        for (const auto& stat : _value.m_details->m_ddsRequests)
+        {
+            setupDDSRequestStat(_response->add_dds(), stat);
+        }
+    }
+}
+
+void CGrpcControlService::setupDiagnosticsReply(odc::DiagnosticsReply* _response,
+                                                const odc::core::SReturnValue& _value,
+                                                const std::string& _partitionID)
+{
+    // Protobuf message takes the ownership and deletes the object
+    odc::GeneralReply* generalResponse = new odc::GeneralReply();
+    setupGeneralReply(generalResponse, _value, _partitionID);
+    _response->set_allocated_reply(generalResponse);
+
+    if (_value.m_details == nullptr)
+        return;
+
+    const SProcessDiagnostics& process{ _value.m_details->m_process };
+    for (const auto& t : process.m_threads)
+    {
+        auto thread = _response->add_threads();
+        thread->set_tid(t.m_tid);
+        thread->set_name(t.m_name);
+        thread->set_usertime(t.m_userTime);
+        thread->set_systemtime(t.m_systemTime);
+        thread->set_voluntaryswitches(t.m_voluntarySwitches);
+        thread->set_involuntaryswitches(t.m_involuntarySwitches);
+    }
+    _response->set_rss(process.m_rss);
+    _response->set_peakrss(process.m_peakRSS);
+    setupPartitionDiagnostics(_response->add_partitions(), _partitionID, _value.m_details->m_diagnostics);
+}
+
+void CGrpcControlService::setupPartitionDiagnostics(odc::PartitionDiagnostics* _response,
+                                                    const std::string& _partitionID,
+                                                    const odc::core::SServiceDiagnostics& _diagnostics)
+{
+    _response->set_partitionid(_partitionID);
+    _response->set_sessionid(_diagnostics.m_sessionID);
+    for (const auto& o : _diagnostics.m_operations)
+    {
+        auto operation = _response->add_operations();
+        operation->set_name(o.m_name);
+        operation->set_age(o.m_age);
+    }
+    for (const auto& l : _diagnostics.m_locks)
+    {
+        auto lock = _response->add_locks();
+        lock->set_name(l.m_name);
+        lock->set_locks(l.m_numLocks);
+        lock->set_waits(l.m_numWaits);
+        lock->set_waittotal(l.m_waitTotal);
+        lock->set_waitmax(l.m_waitMax);
+    }
+}
+
+void CGrpcControlService::setupThroughputReply(odc::ThroughputReply* _response,
+                                               const odc::core::SThroughputSample& _sample)
+{
+    _response->set_sequence(_sample.m_sequence);
+    _response->set_timestamp(_sample.m_timestamp);
+    for (const auto& v : _sample.m_values)
+    {
+        auto value = _response->add_values();
+        value->set_scope(v.m_scope);
+        value->set_name(v.m_name);
+        value->set_key(v.m_key);
+        value->set_value(v.m_value);
+        value->set_devices(v.m_numDevices);
     }
 }
+
+void CGrpcControlService::setupShmSegment(odc::ShmSegment* _response, const odc::core::SShmSegmentStat& _stat)
+{
+    _response->set_host(_stat.m_host);
+    _response->set_segment(_stat.m_segment);
+    _response->set_size(_stat.m_size);
+    _response->set_free(_stat.m_free);
+    _response->set_largestfree(_stat.m_largestFree);
+    _response->set_fragmentation(_stat.fragmentation());
+    _response->set_timestamp(_stat.m_timestamp);
+}
+
+void CGrpcControlService::setupLaunchLatency(odc::LaunchLatency* _response, const odc::core::SLaunchLatency& _latency)
+{
+    _response->set_scope(_latency.m_scope);
+    _response->set_name(_latency.m_name);
+    _response->set_tasks(_latency.m_numTasks);
+    _response->set_reported(_latency.m_numReported);
+    _response->set_launchmedian(_latency.m_launchMedian);
+    _response->set_launchmax(_latency.m_launchMax);
+    _response->set_statemedian(_latency.m_stateMedian);
+    _response->set_statemax(_latency.m_stateMax);
+}
+
+void CGrpcControlService::setupColocatedChannel(odc::ColocatedChannel* _response,
+                                                const odc::core::SColocatedChannel& _channel)
+{
+    _response->set_channel(_channel.m_channel);
+    _response->set_collection(_channel.m_collection);
+    _response->set_host(_channel.m_host);
+    _response->set_devices(_channel.m_numDevices);
+}
+
+void CGrpcControlService::setupPropertyLatency(odc::PropertyLatency* _response,
+                                               const odc::core::SPropertyLatency& _latency)
+{
+    _response->set_property(_latency.m_property);
+    _response->set_host(_latency.m_host);
+    _response->set_writers(_latency.m_numWriters);
+    _response->set_readers(_latency.m_numReaders);
+    _response->set_publishtime(_latency.m_publishTime);
+    _response->set_median(_latency.m_median);
+    _response->set_p90(_latency.m_p90);
+    _response->set_max(_latency.m_max);
+}
+
+void CGrpcControlService::setupDDSRequestStat(odc::DDSRequestStat* _response, const odc::core::SDDSRequestStat& _stat)
+{
+    _response->set_request(_stat.m_request);
+    _response->set_count(_stat.m_count);
+    _response->set_failed(_stat.m_numFailed);
+    _response->set_messages(_stat.m_numMessages);
+    setupHistogram(_response->mutable_firstmessage(), _stat.m_firstMessage);
+    setupHistogram(_response->mutable_done(), _stat.m_done);
+}
+
+void CGrpcControlService::setupHistogram(odc::Histogram* _response, const odc::core::SDurationHistogram& _histogram)
+{
+    *_response->mutable_bounds() = { SDurationHistogram::kBounds.begin(), SDurationHistogram::kBounds.end() };
+    *_response->mutable_counts() = { _histogram.m_counts.begin(), _histogram.m_counts.end() };
+    _response->set_count(_histogram.m_count);
+    _response->set_sum(_histogram.m_sum);
+    _response->set_max(_histogram.m_max);
+}
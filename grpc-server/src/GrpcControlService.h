@@ -7,6 +7,9 @@
 
 // ODC
 #include "ControlService.h"
+// STD
+#include <map>
+#include <mutex>
 
 // GRPC
 #include "odc.grpc.pb.h"
@@ -22,6 +25,13 @@ namespace odc
             CGrpcControlService();
 
             void setSubmitParams(const odc::core::SSubmitParams& _params);
+            void setSamplerParams(const odc::core::SSamplerParams& _params);
+            void setEventLogDir(const std::string& _dir);
+            void setConfigDir(const std::string& _dir);
+            void setAgentCheckInterval(const std::chrono::milliseconds& _interval);
+            void setShmMonitorInterval(const std::chrono::milliseconds& _interval);
+            void setExchangeTiming(bool _enabled);
+            void setCompressionParams(const odc::core::SCompressionParams& _params);
             void setTimeout(const std::chrono::seconds& _timeout);
 
           private:
@@ -37,6 +47,9 @@ namespace odc
             ::grpc::Status Update(::grpc::ServerContext* context,
                                   const odc::UpdateRequest* request,
                                   odc::GeneralReply* response) override;
+            ::grpc::Status RollingUpdate(::grpc::ServerContext* context,
+                                         const odc::RollingUpdateRequest* request,
+                                         odc::RollingUpdateReply* response) override;
             ::grpc::Status Configure(::grpc::ServerContext* context,
                                      const odc::ConfigureRequest* request,
                                      odc::StateChangeReply* response) override;
@@ -55,12 +68,131 @@ namespace odc
             ::grpc::Status Shutdown(::grpc::ServerContext* context,
                                     const odc::ShutdownRequest* request,
                                     odc::GeneralReply* response) override;
+            ::grpc::Status SetProperty(::grpc::ServerContext* context,
+                                       const odc::SetPropertyRequest* request,
+                                       odc::GeneralReply* response) override;
+            ::grpc::Status SaveConfig(::grpc::ServerContext* context,
+                                      const odc::SaveConfigRequest* request,
+                                      odc::GeneralReply* response) override;
+            ::grpc::Status ApplyConfig(::grpc::ServerContext* context,
+                                       const odc::ApplyConfigRequest* request,
+                                       odc::GeneralReply* response) override;
+            ::grpc::Status GetProperties(::grpc::ServerContext* context,
+                                         const odc::GetPropertiesRequest* request,
+                                         odc::GetPropertiesReply* response) override;
+            ::grpc::Status GetTopology(::grpc::ServerContext* context,
+                                       const odc::TopologyRequest* request,
+                                       odc::TopologyReply* response) override;
+            ::grpc::Status GetMetrics(::grpc::ServerContext* context,
+                                      const odc::MetricsRequest* request,
+                                      odc::MetricsReply* response) override;
+            ::grpc::Status Diagnostics(::grpc::ServerContext* context,
+                                       const odc::DiagnosticsRequest* request,
+                                       odc::DiagnosticsReply* response) override;
+            ::grpc::Status SubscribeThroughput(::grpc::ServerContext* context,
+                                               const odc::ThroughputRequest* request,
+                                               ::grpc::ServerWriter<odc::ThroughputReply>* writer) override;
+            ::grpc::Status BulkConfigure(::grpc::ServerContext* context,
+                                         const odc::BulkStateChangeRequest* request,
+                                         odc::BulkStateChangeReply* response) override;
+            ::grpc::Status BulkStart(::grpc::ServerContext* context,
+                                     const odc::BulkStateChangeRequest* request,
+                                     odc::BulkStateChangeReply* response) override;
+            ::grpc::Status BulkStop(::grpc::ServerContext* context,
+                                    const odc::BulkStateChangeRequest* request,
+                                    odc::BulkStateChangeReply* response) override;
+            ::grpc::Status BulkReset(::grpc::ServerContext* context,
+                                     const odc::BulkStateChangeRequest* request,
+                                     odc::BulkStateChangeReply* response) override;
+            ::grpc::Status BulkTerminate(::grpc::ServerContext* context,
+                                         const odc::BulkStateChangeRequest* request,
+                                         odc::BulkStateChangeReply* response) override;
+
+            using StateChangeFunc_t =
+                odc::core::SReturnValue (odc::core::CControlService::*)(const odc::core::SDeviceParams&);
+
+            /// \brief Return service of the partition. Partition is created if it doesn't exist.
+            /// \details Only used by Initialize and Submit, other requests require an existing partition.
+            std::shared_ptr<odc::core::CControlService> getService(const std::string& _partitionID);
+            /// \brief Return service of the partition or nullptr if it doesn't exist
+            std::shared_ptr<odc::core::CControlService> findService(const std::string& _partitionID) const;
+            /// \brief Remove the partition after its shutdown. The default partition is kept.
+            void removeService(const std::string& _partitionID);
+            /// \brief Status of a request to a partition which doesn't exist
+            static ::grpc::Status unknownPartition(const std::string& _partitionID);
+            /// \brief Explicitly listed partitions and existing partitions matching the selector
+            /// \return INVALID_ARGUMENT if the selector is not a valid regular expression
+            ::grpc::Status selectPartitions(const odc::BulkStateChangeRequest& _request,
+                                            std::vector<std::string>& _partitions) const;
+            /// \brief Execute state change concurrently in all selected partitions
+            ::grpc::Status bulkStateChange(const odc::BulkStateChangeRequest& _request,
+                                           odc::BulkStateChangeReply* _response,
+                                           StateChangeFunc_t _func);
+            /// \brief Compress the reply of the call if it is large enough and the peer is not local
+            void compressReply(::grpc::ServerContext* _context, const google::protobuf::Message& _reply) const;
+            /// \brief True if the gRPC peer string, e.g. `ipv4:127.0.0.1:5000`, is a unix socket or a loopback address
+            static bool isLocalPeer(const std::string& _peer);
+
+            /// \brief Degraded-mode continuation parameters of a state change request
+            template <typename Request_t>
+            static odc::core::SStragglerParams stragglerParams(const Request_t& _request);
+            /// \brief Retry parameters of a state change request
+            template <typename Request_t>
+            static odc::core::SRetryParams retryParams(const Request_t& _request);
 
-            void setupGeneralReply(odc::GeneralReply* _response, const odc::core::SReturnValue& _value);
-            void setupStateChangeReply(odc::StateChangeReply* _response, const odc::core::SReturnValue& _value);
+            void setupGeneralReply(odc::GeneralReply* _response,
+                                   const odc::core::SReturnValue& _value,
+                                   const std::string& _partitionID);
+            void setupSubmitReply(odc::GeneralReply* _response,
+                                  const odc::core::SReturnValue& _value,
+                                  const std::string& _partitionID);
+            void setupActivateReply(odc::GeneralReply* _response,
+                                    const odc::core::SReturnValue& _value,
+                                    const std::string& _partitionID);
+            void setupStateChangeReply(odc::StateChangeReply* _response,
+                                       const odc::core::SReturnValue& _value,
+                                       const std::string& _partitionID);
+            void setupGetPropertiesReply(odc::GetPropertiesReply* _response,
+                                         const odc::core::SReturnValue& _value,
+                                         const std::string& _partitionID);
+            void setupRollingUpdateReply(odc::RollingUpdateReply* _response,
+                                         const odc::core::SReturnValue& _value,
+                                         const std::string& _partitionID);
+            void setupMetricsReply(odc::MetricsReply* _response,
+                                   const odc::core::SReturnValue& _value,
+                                   const std::string& _partitionID);
+            void setupThroughputReply(odc::ThroughputReply* _response, const odc::core::SThroughputSample& _sample);
+            void setupShmSegment(odc::ShmSegment* _response, const odc::core::SShmSegmentStat& _stat);
+            void setupTopologyReply(odc::TopologyReply* _response,
+                                    const odc::core::SReturnValue& _value,
+                                    const std::string& _partitionID);
+            void setupLaunchLatency(odc::LaunchLatency* _response, const odc::core::SLaunchLatency& _latency);
+            void setupColocatedChannel(odc::ColocatedChannel* _response, const odc::core::SColocatedChannel& _channel);
+            void setupPropertyLatency(odc::PropertyLatency* _response, const odc::core::SPropertyLatency& _latency);
+            void setupDDSRequestStat(odc::DDSRequestStat* _response, const odc::core::SDDSRequestStat& _stat);
+            void setupHistogram(odc::Histogram* _response, const odc::core::SDurationHistogram& _histogram);
+            void setupDiagnosticsReply(odc::DiagnosticsReply* _response,
+                                       const odc::core::SReturnValue& _value,
+                                       const std::string& _partitionID);
+            void setupPartitionDiagnostics(odc::PartitionDiagnostics* _response,
+                                           const std::string& _partitionID,
+                                           const odc::core::SServiceDiagnostics& _diagnostics);
 
-            std::shared_ptr<odc::core::CControlService> m_service; ///< Core ODC service
-            odc::core::SSubmitParams m_submitParams;               ///< Parameters of the submit request
+            /// Core ODC service per partition. Empty partition ID is the default partition.
+            std::map<std::string, std::shared_ptr<odc::core::CControlService>> m_services;
+            mutable std::mutex m_mutex;                 ///< Protects m_services
+            odc::core::SSubmitParams m_submitParams;    ///< Parameters of the submit request
+            odc::core::SSamplerParams m_samplerParams;  ///< Parameters of the throughput sampler of new partitions
+            std::chrono::seconds m_timeout{ 30 };       ///< Request timeout of new partitions
+            std::string m_eventLogDir;                  ///< Directory of the event logs of new partitions
+            std::string m_configDir;                    ///< Directory of the configuration snapshots
+            /// Interval of agent health checks of new partitions
+            std::chrono::milliseconds m_agentCheckInterval{ 0 };
+            /// Reporting interval of the shared memory helper tasks of new partitions
+            std::chrono::milliseconds m_shmMonitorInterval{ 5000 };
+            bool m_exchangeTiming{ false }; ///< Timing of the channel property exchange in new partitions
+            /// Compression of large replies
+            odc::core::SCompressionParams m_compressionParams;
         };
     } // namespace grpc
 } // namespace odc
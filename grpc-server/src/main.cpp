@@ -29,7 +29,13 @@ int main(int argc, char** argv)
         size_t timeout;
         string host;
         SSubmitParams submitParams;
+        SSamplerParams samplerParams;
         CLogger::SConfig logConfig;
+        string configDir;
+        size_t agentCheckInterval;
+        size_t shmMonitorInterval;
+        bool exchangeTiming;
+        SCompressionParams compressionParams;
 
         // Generic options
         bpo::options_description options("dds-control-server options");
@@ -37,7 +43,13 @@ int main(int argc, char** argv)
         CCliHelper::addTimeoutOptions(options, 30, timeout);
         CCliHelper::addHostOptions(options, "localhost:50051", host);
         CCliHelper::addSubmitOptions(options, SSubmitParams("localhost", "", 1, 36), submitParams);
+        CCliHelper::addSamplerOptions(options, SSamplerParams(), samplerParams);
         CCliHelper::addLogOptions(options, CLogger::SConfig(), logConfig);
+        CCliHelper::addConfigDirOptions(options, "", configDir);
+        CCliHelper::addAgentWatchdogOptions(options, 0, agentCheckInterval);
+        CCliHelper::addShmMonitorOptions(options, 5000, shmMonitorInterval);
+        CCliHelper::addExchangeTimingOptions(options, false, exchangeTiming);
+        CCliHelper::addCompressionOptions(options, SCompressionParams(), compressionParams);
 
         // Parsing command-line
         bpo::variables_map vm;
@@ -81,6 +93,13 @@ int main(int argc, char** argv)
         odc::grpc::CGrpcControlServer server;
         server.setTimeout(chrono::seconds(timeout));
         server.setSubmitParams(submitParams);
+        server.setSamplerParams(samplerParams);
+        server.setEventLogDir(logConfig.m_logDir);
+        server.setConfigDir(configDir.empty() ? logConfig.m_logDir : configDir);
+        server.setAgentCheckInterval(chrono::seconds(agentCheckInterval));
+        server.setShmMonitorInterval(chrono::milliseconds(shmMonitorInterval));
+        server.setExchangeTiming(exchangeTiming);
+        server.setCompressionParams(compressionParams);
         server.Run(host);
     }
     catch (exception& _e)
@@ -0,0 +1,218 @@
+// Copyright 2019 GSI, Inc. All rights reserved.
+//
+// Helper task reporting the usage of FairMQ shared memory segments on its node.
+// Started as a DDS task, one per agent. ODC subscribes to the reports via a DDS custom command.
+//
+
+// ODC
+#include "ShmMonitor.h"
+// STD
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+// BOOST
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/regex.hpp>
+// DDS
+#include <dds/Intercom.h>
+
+using namespace std;
+using namespace odc::core;
+using namespace dds::intercom_api;
+namespace bpo = boost::program_options;
+namespace bfs = boost::filesystem;
+namespace bip = boost::interprocess;
+
+namespace
+{
+    atomic<bool> gStop{ false };
+
+    void signalHandler(int /*_signal*/)
+    {
+        gStop = true;
+    }
+
+    /// \brief Find the largest allocatable block by a binary search of allocations
+    /// \details Boost.Interprocess doesn't expose the largest free block. Each allocation takes the segment lock,
+    /// so probing competes with the devices and is disabled by default.
+    /// \param [in] _granularity Precision of the search in bytes
+    uint64_t probeLargestFree(bip::managed_shared_memory& _segment, uint64_t _free, uint64_t _granularity)
+    {
+        uint64_t lo{ 0 };
+        uint64_t hi{ _free };
+        while (hi - lo > _granularity)
+        {
+            const uint64_t mid{ lo + (hi - lo) / 2 };
+            void* ptr{ _segment.allocate(mid, nothrow) };
+            if (ptr != nullptr)
+            {
+                _segment.deallocate(ptr);
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    SShmSegmentStat::container_t collectStats(const string& _host,
+                                              const boost::regex& _segmentRegex,
+                                              bool _probe,
+                                              uint64_t _granularity)
+    {
+        SShmSegmentStat::container_t stats;
+        const uint64_t timestamp(
+            chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count());
+
+        // POSIX shared memory objects of FairMQ are visible in /dev/shm on Linux
+        boost::system::error_code ec;
+        for (bfs::directory_iterator it("/dev/shm", ec), end; !ec && it != end; it.increment(ec))
+        {
+            const string name{ it->path().filename().string() };
+            if (!boost::regex_match(name, _segmentRegex))
+                continue;
+
+            try
+            {
+                bip::managed_shared_memory segment(bip::open_only, name.c_str());
+                SShmSegmentStat stat;
+                stat.m_host = _host;
+                stat.m_segment = name;
+                stat.m_size = segment.get_size();
+                stat.m_free = segment.get_free_memory();
+                stat.m_largestFree = (_probe) ? probeLargestFree(segment, stat.m_free, _granularity) : 0;
+                stat.m_timestamp = timestamp;
+                stats.push_back(stat);
+            }
+            catch (exception& _e)
+            {
+                cerr << "Failed to open shared memory segment " << name << ": " << _e.what() << endl;
+            }
+        }
+        return stats;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        size_t interval;
+        string segmentRegex;
+        bool probe;
+        size_t granularity;
+
+        // Generic options
+        bpo::options_description options("odc-shm-monitor options");
+        options.add_options()("help,h", "Produce help message");
+        options.add_options()("interval",
+                              bpo::value<size_t>(&interval)->default_value(5000),
+                              "Reporting interval in ms. Overwritten by the subscription request of ODC.");
+        options.add_options()("segments",
+                              bpo::value<string>(&segmentRegex)->default_value("fmq_.*_(main|m_[0-9]+)"),
+                              "Regular expression matching names of FairMQ shared memory segments in /dev/shm");
+        options.add_options()("probe",
+                              bpo::value<bool>(&probe)->default_value(false),
+                              "Probe the largest allocatable block in order to compute fragmentation. Each probe "
+                              "allocates under the segment lock and can delay the devices.");
+        options.add_options()("probe-granularity",
+                              bpo::value<size_t>(&granularity)->default_value(4096),
+                              "Precision of the largest block probe in bytes");
+
+        // Parsing command-line
+        bpo::variables_map vm;
+        bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+        bpo::notify(vm);
+
+        if (vm.count("help"))
+        {
+            cout << options;
+            return EXIT_SUCCESS;
+        }
+
+        signal(SIGINT, signalHandler);
+        signal(SIGTERM, signalHandler);
+
+        const string host{ boost::asio::ip::host_name() };
+        const boost::regex regex(segmentRegex);
+
+        mutex mtx;
+        set<uint64_t> subscribers;
+        chrono::milliseconds reportInterval(interval);
+
+        CIntercomService service;
+        CCustomCmd customCmd(service);
+
+        service.subscribeOnError([](EErrorCode _code, const string& _msg) {
+            cerr << "DDS intercom error " << static_cast<int>(_code) << ": " << _msg << endl;
+        });
+
+        customCmd.subscribe([&](const string& _cmd, const string& /*_condition*/, uint64_t _senderID) {
+            if (_cmd.compare(0, kShmSubscribeCmd.size(), kShmSubscribeCmd) != 0)
+                return;
+
+            lock_guard<mutex> lock(mtx);
+            subscribers.insert(_senderID);
+            try
+            {
+                reportInterval = chrono::milliseconds(stoull(_cmd.substr(kShmSubscribeCmd.size())));
+            }
+            catch (exception&)
+            {
+            }
+            cout << "New subscriber " << _senderID << ", reporting interval " << reportInterval.count() << " ms"
+                 << endl;
+        });
+
+        service.start();
+
+        auto next{ chrono::steady_clock::now() };
+        while (!gStop)
+        {
+            this_thread::sleep_for(chrono::milliseconds(100));
+            if (chrono::steady_clock::now() < next)
+                continue;
+
+            set<uint64_t> targets;
+            {
+                lock_guard<mutex> lock(mtx);
+                targets = subscribers;
+                next = chrono::steady_clock::now() + reportInterval;
+            }
+            if (targets.empty())
+                continue;
+
+            const string cmd{ SShmSegmentStat::toCmd(collectStats(host, regex, probe, max<size_t>(granularity, 1))) };
+            for (auto target : targets)
+            {
+                customCmd.send(cmd, to_string(target));
+            }
+        }
+
+        service.stop();
+    }
+    catch (exception& _e)
+    {
+        cerr << _e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    catch (...)
+    {
+        cerr << "Unexpected Exception occurred." << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}